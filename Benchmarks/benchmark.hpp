@@ -4,7 +4,11 @@
 #include <chrono>
 #include <numeric>
 #include <memory>
-#include <list>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <string>
+#include "histogram.hpp"
 
 namespace MC {
 
@@ -26,44 +30,96 @@ class Benchmark {
 
     using ms = std::chrono::microseconds;
 
+    // per operation type, in nanoseconds; only filled when asked for, as
+    // reading the clock around every operation adds to the total time
+    bool latencies;
+    LatencyHistogram histograms[3];
+
+    // records the time until it goes out of scope
+    struct Stopwatch {
+        LatencyHistogram* histogram;
+        std::chrono::steady_clock::time_point start;
+
+        ~Stopwatch() {
+            if (!histogram)
+                return;
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            histogram->Record(std::chrono::duration_cast< std::chrono::nanoseconds >(elapsed).count());
+        }
+    };
+
+    Stopwatch Watch(OP::type type) {
+        if (!latencies)
+            return Stopwatch{ nullptr, {} };
+        return Stopwatch{ &histograms[static_cast< int >(type)], std::chrono::steady_clock::now() };
+    }
+
     ms RunOperations(const std::vector< OP >& operations) {
-        using Node = typename T::NodeType;
-        using uptr = std::unique_ptr< Node >;
+        using Handle = typename T::Handle;
         using std::chrono::duration_cast;
 
-        std::list< const Node* > inserted;
+        // items are serial ids, which index the place of every live handle,
+        // so that both picking a handle and dropping an extracted one are O(1)
+        struct Inserted {
+            Handle handle;
+            int key;
+            int id;
+        };
+
+        std::vector< Inserted > inserted;
+        std::vector< std::size_t > slot;
+        int ids = 0;
 
         T heap;
 
+        auto insert = [this, &inserted, &slot, &ids, &heap](int key) {
+            Handle handle{};
+            {
+                auto watch = Watch(OP::type::Insert);
+                handle = heap.Insert(key, ids);
+            }
+            slot.push_back(inserted.size());
+            inserted.push_back(Inserted{ handle, key, ids });
+            ++ids;
+        };
+
         auto start = timer.now();
         for (auto op : operations) {
             try {
 
                 switch (op.op) {
                 case OP::type::Insert:
-                    inserted.push_back(heap.Insert(op.key, op.value));
+                    insert(op.key);
                     break;
                 case OP::type::DecreaseKey: {
                     if (heap.Empty()) {
-                        inserted.push_back(heap.Insert(op.key, op.value));
+                        insert(op.key);
                         continue;
                     }
 
-                    auto it = inserted.begin();
-                    std::advance(it, op.value % inserted.size());
-                    auto n = *it;
-                    int k = n->key > op.key ? op.key : n->key - 1;
-                    heap.DecreaseKey(n, k);
+                    auto& i = inserted[static_cast< std::size_t >(op.value) % inserted.size()];
+                    int k = i.key > op.key ? op.key : i.key - 1;
+                    {
+                        auto watch = Watch(OP::type::DecreaseKey);
+                        heap.DecreaseKey(i.handle, k);
+                    }
+                    i.key = k;
                     break;
                 }
                 case OP::type::ExtractMin: {
                     if (heap.Empty()) {
-                        inserted.push_back(heap.Insert(op.key, op.value));
+                        insert(op.key);
                         continue;
                     }
-                    uptr p = heap.ExtractMin();
-                    auto it = std::find(inserted.begin(), inserted.end(), p.get());
-                    inserted.erase(it);
+                    int id;
+                    {
+                        auto watch = Watch(OP::type::ExtractMin);
+                        id = heap.Pop().second;
+                    }
+                    // the last live handle takes the place of the extracted one
+                    inserted[slot[id]] = inserted.back();
+                    slot[inserted.back().id] = slot[id];
+                    inserted.pop_back();
                     break;
                 }
                 }
@@ -79,6 +135,8 @@ class Benchmark {
 public:
     std::vector< ms > results;
 
+    explicit Benchmark(bool latencies = false) : latencies(latencies) {}
+
 
     void Run(const std::vector< OP >& sequence)  {
         using std::chrono::microseconds;
@@ -94,6 +152,17 @@ public:
     }
 
     std::string Name() const { return T().Name; }
+
+    const LatencyHistogram& Latencies(OP::type type) const {
+        return histograms[static_cast< int >(type)];
+    }
+
+    // one row of the latency table per operation type
+    void PrintLatencies(std::ostream& out) const {
+        const char* names[] = { "insert", "decrease", "extract" };
+        for (int i = 0; i < 3; ++i)
+            PrintLatencyRow(out, Name(), names[i], histograms[i]);
+    }
 };
 
 }
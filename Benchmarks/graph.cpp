@@ -1,14 +1,22 @@
 #include <ImplicitHeap/implicit_heap.hpp>
+#include <ImplicitHeap/dary_heap.hpp>
 #include <ExplicitHeap/explicit_heap.hpp>
 #include <FibonacciHeap/fibonacci_heap.hpp>
 #include <ViolationHeap/violation_heap.hpp>
 #include <RankPairingHeap/rp_heap.hpp>
 #include <BinomialHeap/binomial_heap.hpp>
 #include <RankPairingHeap/rp_heap_t2.hpp>
+#include <PairingHeap/pairing_heap.hpp>
+#include <RadixHeap/radix_heap.hpp>
+#include <BucketQueue/bucket_queue.hpp>
+#include <StrictFibonacciHeap/strict_fibonacci_heap.hpp>
 
 #include <cctype>
+#include <iomanip>
 
 #include "graph.hpp"
+#include "histogram.hpp"
+#include "scenario.hpp"
 
 using std::chrono::high_resolution_clock;
 using std::chrono::microseconds;
@@ -39,36 +47,116 @@ Ret LogAndRun(const std::string& text, std::function< Ret()> func) {
 
 std::map< std::string, double > averages;
 
-template < template < typename > typename T >
-std::vector< int > RunImpl(const map_t& map, int iterations, int dij) {
+// the queries of the -s scenario; without one every iteration searches from
+// the first to the last vertex
+std::vector< Query > queries;
+
+struct Bucket {
+    LatencyHistogram latency;
+    long long total = 0;
+    int failed = 0;
+};
+
+// runs every query of the scenario iterations times
+template < typename G >
+std::map< int, Bucket > RunScenario(G& g, int iterations, int dij) {
+    std::map< int, Bucket > buckets;
+    for (int i = 0; i < iterations; ++i) {
+        for (const auto& q : queries) {
+            auto& b = buckets[q.bucket];
+            auto from = g.Find({ q.startY, q.startX });
+            auto to = g.Find({ q.goalY, q.goalX });
+            if (from == G::None || to == G::None) {
+                ++b.failed;
+                continue;
+            }
+
+            g.ResetDistances();
+            auto s = timer.now();
+            try {
+                if (dij == 1)
+                    g.Dijkstra(from, to);
+                else
+                    g.Dijkstra2(from, to);
+            } catch (const std::logic_error&) {
+                ++b.failed;
+                continue;
+            }
+            auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >(timer.now() - s).count();
+            b.latency.Record(ns);
+            b.total += ns;
+        }
+    }
+    return buckets;
+}
+
+// prints the throughput and the latency in us of every bucket; returns the
+// mean query time in ms
+double PrintBuckets(const std::map< int, Bucket >& buckets) {
+    std::cout << std::setw(8) << "bucket" << std::setw(10) << "queries" << std::setw(8) << "failed"
+              << std::setw(12) << "queries/s" << std::setw(10) << "mean" << std::setw(10) << "p50"
+              << std::setw(10) << "p99" << std::setw(10) << "max" << std::endl;
+    long long total = 0;
+    std::uint64_t count = 0;
+    for (const auto& [bucket, b] : buckets) {
+        auto n = b.latency.Count();
+        total += b.total;
+        count += n;
+        std::cout << std::setw(8) << bucket << std::setw(10) << n << std::setw(8) << b.failed
+                  << std::setw(12) << std::fixed << std::setprecision(0) << (b.total ? n * 1e9 / b.total : 0)
+                  << std::setprecision(1)
+                  << std::setw(10) << (n ? b.total / 1000.0 / n : 0)
+                  << std::setw(10) << b.latency.Percentile(0.5) / 1000.0
+                  << std::setw(10) << b.latency.Percentile(0.99) / 1000.0
+                  << std::setw(10) << b.latency.Max() / 1000.0 << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+    return count ? total / 1e6 / count : 0;
+}
+
+template < template < typename... > typename T >
+std::vector< int > RunImpl(const std::string& file, const MapFile& map, bool cache, int iterations, int dij) {
     std::cout << "---------------------------------------" << std::endl;
     Graph<T> g;
     auto n = g.HeapName();
     std::cout << n << ": " << std::endl;
-    LogAndRun("populating graph", [&](){ g.Load(map); });
+    if (cache) {
+        LogAndRun("loading graph cache", [&](){ g.LoadCached(file, file + ".graph"); });
+    } else {
+        LogAndRun("adding vertices", [&](){ g.AddVertices(map); });
+        LogAndRun("linking neighbours", [&](){ g.SetNeighbours(); });
+    }
     std::vector< int > runs;
-    LogAndRun("Total", [&]() {
-        for (int i = 0; i < iterations; ++i)
-        {
-            bool succ = false;
-            while (!succ) {
-                try {
-                    auto& from = g.FirstVertex();
-                    auto& to = g.LastVertex();
-                    g.ResetDistances();
-                    auto s = timer.now();
-                    if (dij == 1)
-                        g.Dijkstra(from, to);
-                    else
-                        g.Dijkstra2(from, to);
-                    runs.push_back(duration_cast< milliseconds >(timer.now() - s).count());
-                    succ = true;
-                } catch (std::logic_error) { }
+    double t;
+    if (!queries.empty()) {
+        std::map< int, Bucket > buckets;
+        LogAndRun("Total", [&]() { buckets = RunScenario(g, iterations, dij); });
+        t = PrintBuckets(buckets);
+    } else {
+        LogAndRun("Total", [&]() {
+            for (int i = 0; i < iterations; ++i)
+            {
+                bool succ = false;
+                while (!succ) {
+                    try {
+                        auto from = g.FirstVertex();
+                        auto to = g.LastVertex();
+                        g.ResetDistances();
+                        auto s = timer.now();
+                        if (dij == 1)
+                            g.Dijkstra(from, to);
+                        else
+                            g.Dijkstra2(from, to);
+                        runs.push_back(duration_cast< milliseconds >(timer.now() - s).count());
+                        succ = true;
+                    } catch (std::logic_error) { }
+                }
             }
-        }
-    });
+        });
+        t = std::accumulate(runs.begin(), runs.end(), 0ul) / static_cast< double >(runs.size());
+    }
 
-    auto t = std::accumulate(runs.begin(), runs.end(), 0ul) / static_cast< double >(runs.size());
     std::cout << "Average: " << t << "ms" << std::endl;
     std::cout << "---------------------------------------" << std::endl;
     std::transform(n.begin(), n.end(), n.begin(), [](char c) { return std::tolower(c); });
@@ -77,27 +165,36 @@ std::vector< int > RunImpl(const map_t& map, int iterations, int dij) {
 }
 
 auto GetMap(const std::string& filename) {
-//    map_t g = LogAndRun("loading '" + filename + "'",
-//                       [&filename](){
-//                           return Graph< ImplicitHeap >::LoadFile(filename);
-//                       });
-    std::cout << "loading '" << filename << "': ";
-    std::flush(std::cout);
-    auto s = timer.now();
-    auto g =  Graph< ImplicitHeap >::LoadFile(filename);
-    std::cout << duration_cast< milliseconds >(timer.now() - s).count() / 1000.0 << "s" << std::endl;
-    return g;
+    return LogAndRun< MapFile >("loading '" + filename + "'",
+                              [&filename]() {
+                                  return Graph< ImplicitHeap >::LoadFile(filename);
+                              });
 }
 
-void Run(const std::string& file, int iterations, int dij) {
-    auto map = GetMap(file);
-    RunImpl<ImplicitHeap>(map, iterations, dij);
-    RunImpl<ExplicitHeap>(map, iterations, dij);
-    RunImpl<FibonacciHeap>(map, iterations, dij);
-    RunImpl<BinomialHeap>(map, iterations, dij);
-    RunImpl<ViolationHeap>(map, iterations, dij);
-    RunImpl<RankPairingHeap>(map, iterations, dij);
-    RunImpl<RankPairingHeap2>(map, iterations, dij);
+// with cache, every heap loads the graph from file.graph, which the first
+// one writes if it is missing or older than the map
+void Run(const std::string& file, bool cache, int iterations, int dij) {
+    MapFile map;
+    if (!cache)
+        map = GetMap(file);
+    RunImpl<ImplicitHeap>(file, map, cache, iterations, dij);
+    RunImpl<FlatImplicitHeap>(file, map, cache, iterations, dij);
+    RunImpl<Dary4Heap>(file, map, cache, iterations, dij);
+    RunImpl<Dary8Heap>(file, map, cache, iterations, dij);
+    RunImpl<Dary16Heap>(file, map, cache, iterations, dij);
+    RunImpl<ExplicitHeap>(file, map, cache, iterations, dij);
+    RunImpl<FibonacciHeap>(file, map, cache, iterations, dij);
+    RunImpl<IncrementalFibonacciHeap>(file, map, cache, iterations, dij);
+    RunImpl<StrictFibonacciHeap>(file, map, cache, iterations, dij);
+    RunImpl<BinomialHeap>(file, map, cache, iterations, dij);
+    RunImpl<LazyBinomialHeap>(file, map, cache, iterations, dij);
+    RunImpl<ViolationHeap>(file, map, cache, iterations, dij);
+    RunImpl<RankPairingHeap>(file, map, cache, iterations, dij);
+    RunImpl<RankPairingHeap2>(file, map, cache, iterations, dij);
+    RunImpl<PairingHeap>(file, map, cache, iterations, dij);
+    RunImpl<MultipassPairingHeap>(file, map, cache, iterations, dij);
+    RunImpl<RadixHeap>(file, map, cache, iterations, dij);
+    RunImpl<BucketQueue>(file, map, cache, iterations, dij);
 }
 
 
@@ -127,8 +224,9 @@ bool CmdOptionExists(const char** begin, const char** end, const std::string& op
 }
 
 int main(int argc, const char** argv) {
-    if (argc != 6) {
-        std::cerr << "Invalid number of arguments. Example: \"./graph -d2 -f ../maps/maze512-2-0.map -i 1\"" << std::endl;
+    if (argc < 6) {
+        std::cerr << "Invalid number of arguments. Example: \"./graph -d2 -f ../maps/maze512-2-0.map -i 1 "
+                  << "[-c] [-s ../maps/maze512-2-0.map.scen]\"" << std::endl;
         return 1;
     }
 
@@ -162,7 +260,15 @@ int main(int argc, const char** argv) {
     }
 
 
-    Run(file, iterations, dij);
+    bool cache = CmdOptionExists(argv, argv + argc, "-c");
+
+    if (auto scenario = GetCmdOption(argv, argv + argc, "-s")) {
+        queries = LogAndRun< std::vector< Query > >(std::string("loading '") + scenario + "'",
+                                                   [scenario]() { return LoadScenario(scenario); });
+        std::cout << queries.size() << " queries" << std::endl;
+    }
+
+    Run(file, cache, iterations, dij);
 
     NormalizeResults();
     return 0;
@@ -2,21 +2,39 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
 #include <sstream>
 #include <iostream>
 #include <fstream>
 #include <stack>
 #include <chrono>
 #include <map>
+#include <numeric>
 #include <random>
-#include <unordered_map>
+#include <string>
+#include <thread>
+
+#include "map_file.hpp"
 
 namespace MC {
 
 using map_t = std::vector< std::vector< char > >;
 
+// the graph cache is only an optimisation, so failing to write it is
+// reported once and the benchmark goes on
+inline void WarnCacheNotWritten(const std::string& reason) {
+    static bool warned = false;
+    if (!warned)
+        std::cerr << "warning: " << reason << ", the graph is not cached" << std::endl;
+    warned = true;
+}
+
 
-template < template < typename > typename Heap >
+template < template < typename... > typename Heap >
 class Graph {
 public:
 
@@ -27,66 +45,28 @@ public:
         bool operator==(Indices o) const { return row == o.row && col == o.col; }
     };
 
-    struct Vertex;
-    using HeapType = Heap< Vertex* >;
-    using Handle = const typename HeapType::NodeType*;
-
-    struct Vertex {
-        std::vector< Vertex* > neighbors;
-        Indices indices;
+    // vertices are numbered row by row; the edges are stored in compressed
+    // sparse row form, the neighbours of v are neighbours[offsets[v]] up to
+    // neighbours[offsets[v + 1]], and the search state lives in arrays of its
+    // own, so relaxing an edge touches no more than it reads
+    using VertexId = std::uint32_t;
+    using HeapType = Heap< VertexId >;
+    using Handle = typename HeapType::Handle;
 
-        Vertex(Indices i) : indices(i) {}
+    constexpr static VertexId None = std::numeric_limits< VertexId >::max();
 
-        Handle handle = nullptr;
+    // size and modification time of a map file, a cached graph is valid only
+    // for the map it was built from
+    struct SourceKey {
+        std::uint64_t size = 0;
+        std::int64_t time = 0;
 
-        int dist;
-
-        Vertex* prev = nullptr;
-
-        std::string ToString() const {
-            return "[" + std::to_string(indices.row) + "," + std::to_string(indices.col) + "]";
-        }
+        bool operator==(SourceKey o) const { return size == o.size && time == o.time; }
     };
 
 private:
 
 
-    struct MapParams {
-        int width;
-        int height;
-    };
-
-
-    static void SetParams(const std::string& line, MapParams& p ) {
-        std::stringstream ss(line);
-        std::string what, value;
-        std::getline(ss, what, ' ');
-        std::getline(ss, value);
-
-        int v = std::stoi(value);
-
-        if (what[0] == 'w')
-            p.width = v;
-        else
-            p.height = v;
-    }
-
-    static map_t GetMetadata(std::ifstream& f) {
-        std::string line;
-        MapParams p;
-        std::getline(f, line); // map type
-        std::getline(f, line); // param
-        SetParams(line , p);
-        std::getline(f, line); // 2nd param
-        SetParams(line, p);
-
-        std::getline(f, line); // last
-
-        std::vector< char > inner(p.height);
-
-        return map_t(p.width, inner);
-    }
-
     static auto Left(Indices indices) { --indices.col; return indices; }
     static auto Up(Indices indices) { --indices.row; return indices; }
     static auto Right(Indices indices) { ++indices.col; return indices; }
@@ -97,35 +77,50 @@ private:
     static auto DownRight(Indices indices) { return Down(Right(indices)); }
     static auto DownLeft(Indices indices) { return Down(Left(indices)); }
 
-    void SetNeighbours() {
-        auto find = [this](Indices i) -> Vertex* {
-            if (i.row >= vertices.size())
-                return nullptr;
-            auto& v = vertices[i.row];
-            auto it = std::find_if(v.begin(), v.end(), [i](const auto& x) { return x.indices == i; });
-            if (it != v.end())
-                return &*it;
-            return nullptr;
-        };
+    constexpr static char Magic[8] = { 'M', 'C', 'G', 'R', 'A', 'P', 'H', '1' };
 
-        auto setNeighbour = [&find](auto& v, auto f) {
-            auto i = f(v.indices);
-            if (auto x = find(i); x != nullptr)
-                v.neighbors.push_back(x);
-        };
+    struct BinaryHeader {
+        char magic[8];
+        SourceKey source;
+        std::int32_t height;
+        std::int32_t width;
+        std::uint64_t vertices;
+        std::uint64_t edges;
+    };
 
-        for (auto& vector :vertices) {
-            for (auto& v : vector) {
-                setNeighbour(v, Left);
-                setNeighbour(v, UpLeft);
-                setNeighbour(v, Up);
-                setNeighbour(v, UpRight);
-                setNeighbour(v, Right);
-                setNeighbour(v, DownRight);
-                setNeighbour(v, Down);
-                setNeighbour(v, DownLeft);
-            }
-        }
+    template < typename T >
+    static void Write(std::ofstream& out, const std::vector< T >& v) {
+        out.write(reinterpret_cast< const char* >(v.data()), v.size() * sizeof(T));
+    }
+
+    template < typename T >
+    static void Read(const char*& data, std::vector< T >& v, std::size_t count) {
+        v.resize(count);
+        std::memcpy(v.data(), data, count * sizeof(T));
+        data += count * sizeof(T);
+    }
+
+    void ResizeState() {
+        dist.resize(cells.size());
+        prev.resize(cells.size());
+        handles.resize(cells.size());
+        queued.resize(cells.size());
+        ResetDistances();
+    }
+
+    // runs f(first, last) on blocks of consecutive rows, one block per thread
+    template < typename F >
+    static void ForRows(std::size_t count, F f) {
+        std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, count / 64 + 1);
+        std::size_t block = (count + threads - 1) / threads;
+
+        std::vector< std::thread > pool;
+        for (std::size_t first = block; first < count; first += block)
+            pool.emplace_back(f, first, std::min(count, first + block));
+        f(std::size_t(0), std::min(count, block));
+        for (auto& t : pool)
+            t.join();
     }
 
 public:
@@ -138,154 +133,321 @@ public:
         Load(LoadFile(filename));
     }
 
-    Graph(const map_t& map) {
+    // map is a map_t or a MapFile
+    template < typename Map >
+    Graph(const Map& map) {
         Load(map);
     }
 
-    static map_t LoadFile(const std::string& filename) {
-        std::ifstream map(filename);
-        if (!map.is_open())
-            throw std::logic_error("file '" + filename + "' not found");
-        std::string line;
-
-        int row = 0;
-        auto v = GetMetadata(map);
-
-        while (std::getline(map, line)) {
-            int col = 0;
-            for (char c : line) {
-                v[row][col] = c;
-                ++col;
-            }
-            ++row;
-        }
-
-        return v;
+    static MapFile LoadFile(const std::string& filename) {
+        return MapFile(filename);
     }
 
-    const Vertex& RandomVertex() const {
+    VertexId RandomVertex() const {
         std::random_device r;
         std::mt19937_64 rng(r());
-        std::uniform_int_distribution< int > uid;
 
-        if (vertices.size() == 0)
+        if (cells.empty())
             throw std::logic_error("empty");
 
-        int row = uid(rng) % vertices.size();
+        std::uniform_int_distribution< VertexId > uid(0, Size() - 1);
+        return uid(rng);
+    }
 
-        if (vertices[row].size() == 0)
-            throw std::logic_error("empty");
+    VertexId FirstVertex() const {
+        if (cells.empty())
+            throw std::logic_error("no vertices");
+        return 0;
+    }
 
-        int col = uid(rng) % vertices[row].size();
+    VertexId LastVertex() const {
+        if (cells.empty())
+            throw std::logic_error("no vertices");
+        return Size() - 1;
+    }
 
-        return vertices[row][col];
+    VertexId Size() const {
+        return static_cast< VertexId >(cells.size());
     }
 
-    const Vertex& FirstVertex() const {
-        for (auto& v : vertices) {
-            if (!v.empty())
-                return v[0];
-        }
-        throw std::logic_error("no vertices");
+    const Indices& Cell(VertexId v) const {
+        return cells[v];
     }
 
-    const Vertex& LastVertex() const {
-        return vertices.back().back();
+    std::string ToString(VertexId v) const {
+        return "[" + std::to_string(cells[v].row) + "," + std::to_string(cells[v].col) + "]";
     }
 
 
-    void Load(const map_t& map) {
-        int row = 0;
-        vertices = decltype(vertices)(map.size());
-        for (auto& v :  map) {
-            int col = 0;
-            for (char c : v) {
-                if (c == '.') {
-                    vertices[row].push_back(Vertex({ row, col }));
+    template < typename Map >
+    void Load(const Map& map) {
+        AddVertices(map);
+        SetNeighbours();
+    }
+
+    // numbers the open cells row by row and fills the cell -> vertex grid
+    template < typename Map >
+    void AddVertices(const Map& map) {
+        height = static_cast< int >(map.size());
+        width = 0;
+        for (int r = 0; r < height; ++r)
+            width = std::max(width, static_cast< int >(map[r].size()));
+
+        rows.assign(height + 1, 0);
+        ForRows(height, [&](std::size_t first, std::size_t last) {
+            for (auto r = first; r < last; ++r)
+                rows[r + 1] = static_cast< std::uint32_t >(std::count(map[r].begin(), map[r].end(), '.'));
+        });
+        std::partial_sum(rows.begin(), rows.end(), rows.begin());
+
+        cells.resize(rows.back());
+        grid.assign(static_cast< std::size_t >(height) * width, None);
+        ForRows(height, [&](std::size_t first, std::size_t last) {
+            for (auto r = first; r < last; ++r) {
+                auto id = rows[r];
+                for (int col = 0; col < static_cast< int >(map[r].size()); ++col) {
+                    if (map[r][col] == '.') {
+                        cells[id] = { static_cast< int >(r), col };
+                        grid[r * width + col] = id++;
+                    }
                 }
-                ++col;
             }
-            ++row;
-        }
+        });
 
-        SetNeighbours();
+        ResizeState();
     }
 
-    std::vector< std::vector< Vertex >> vertices;
+    // counts the neighbours of every vertex, then writes them in place
+    void SetNeighbours() {
+        constexpr Indices (*directions[])(Indices) = {
+            Left, UpLeft, Up, UpRight, Right, DownRight, Down, DownLeft
+        };
 
-    void ResetDistances() {
-        for (auto& vector : vertices) {
-            for (auto &v : vector) {
-                v.dist = HeapType::Infinity;
+        offsets.assign(cells.size() + 1, 0);
+        ForRows(height, [&](std::size_t first, std::size_t last) {
+            for (auto v = rows[first]; v < rows[last]; ++v) {
+                for (auto f : directions)
+                    offsets[v + 1] += Find(f(cells[v])) != None;
+            }
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        neighbours.resize(offsets.back());
+        ForRows(height, [&](std::size_t first, std::size_t last) {
+            for (auto v = rows[first]; v < rows[last]; ++v) {
+                auto e = offsets[v];
+                for (auto f : directions) {
+                    if (auto x = Find(f(cells[v])); x != None)
+                        neighbours[e++] = x;
+                }
             }
+        });
+    }
+
+    // the vertex at i, or None
+    VertexId Find(Indices i) const {
+        if (i.row < 0 || i.col < 0 || i.row >= height || i.col >= width)
+            return None;
+        return grid[static_cast< std::size_t >(i.row) * width + i.col];
+    }
+
+    static SourceKey KeyOf(const std::string& filename) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(filename, error);
+        auto time = error ? std::filesystem::file_time_type() : std::filesystem::last_write_time(filename, error);
+        if (error)
+            throw std::logic_error("file '" + filename + "' not found");
+        return { static_cast< std::uint64_t >(size), static_cast< std::int64_t >(time.time_since_epoch().count()) };
+    }
+
+    // writes the vertices and the edges in native byte order; the file is
+    // written aside and renamed, so that a concurrent reader never sees half of it
+    void SaveBinary(const std::string& filename, SourceKey key) const {
+        BinaryHeader h;
+        std::copy(std::begin(Magic), std::end(Magic), h.magic);
+        h.source = key;
+        h.height = height;
+        h.width = width;
+        h.vertices = cells.size();
+        h.edges = neighbours.size();
+
+        auto temporary = filename + ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary);
+            if (!out.is_open())
+                throw std::logic_error("cannot write '" + temporary + "'");
+            out.write(reinterpret_cast< const char* >(&h), sizeof(h));
+            Write(out, rows);
+            Write(out, cells);
+            Write(out, offsets);
+            Write(out, neighbours);
+            if (!out)
+                throw std::logic_error("cannot write '" + temporary + "'");
         }
+        if (std::rename(temporary.c_str(), filename.c_str()) != 0)
+            throw std::logic_error("cannot rename '" + temporary + "'");
     }
 
-    void Dijkstra(const Vertex& from, const Vertex& to) {
-        auto f = from.indices;
-        auto t = to.indices;
-        HeapType h;
+    // false if the file is missing, is not a graph, was built from another map
+    // or does not hold together
+    bool LoadBinary(const std::string& filename, SourceKey key) {
+        MappedFile file;
+        try {
+            file = MappedFile(filename);
+        } catch (const std::logic_error&) {
+            return false;
+        }
 
-        for (auto& vector : vertices) {
-            for (auto& v : vector) {
-                if (v.indices == f)
-                    v.dist = 0;
-                auto node = h.Insert(v.dist, &v);
-                node->item->handle = node;
+        BinaryHeader h;
+        if (file.Size() < sizeof(h))
+            return false;
+        std::memcpy(&h, file.Data(), sizeof(h));
+        if (!std::equal(std::begin(Magic), std::end(Magic), h.magic) || !(h.source == key))
+            return false;
+
+        if (h.height < 0 || h.width < 0 || h.vertices >= None || h.edges > std::numeric_limits< std::uint32_t >::max())
+            return false;
+        std::uint64_t expected = sizeof(h) + (std::uint64_t(h.height) + 1) * sizeof(std::uint32_t)
+                + h.vertices * sizeof(Indices) + (h.vertices + 1) * sizeof(std::uint32_t)
+                + h.edges * sizeof(VertexId);
+        if (file.Size() != expected)
+            return false;
+
+        height = h.height;
+        width = h.width;
+        auto data = file.Data() + sizeof(h);
+        Read(data, rows, height + 1);
+        Read(data, cells, h.vertices);
+        Read(data, offsets, h.vertices + 1);
+        Read(data, neighbours, h.edges);
+        if (!Consistent())
+            return false;
+
+        grid.assign(static_cast< std::size_t >(height) * width, None);
+        ForRows(height, [&](std::size_t first, std::size_t last) {
+            for (auto v = rows[first]; v < rows[last]; ++v)
+                grid[static_cast< std::size_t >(cells[v].row) * width + cells[v].col] = v;
+        });
+        ResizeState();
+        return true;
+    }
+
+    // whether arrays read from a file describe a graph: every vertex lies in
+    // the row rows gives it, left to right inside the grid, and every edge
+    // leads to a vertex
+    bool Consistent() const {
+        if (rows.front() != 0 || rows.back() != cells.size() || !std::is_sorted(rows.begin(), rows.end()))
+            return false;
+        for (int r = 0; r < height; ++r) {
+            for (auto v = rows[r]; v < rows[r + 1]; ++v) {
+                if (cells[v].row != r || cells[v].col < 0 || cells[v].col >= width)
+                    return false;
+                if (v > rows[r] && cells[v - 1].col >= cells[v].col)
+                    return false;
             }
         }
 
+        if (offsets.front() != 0 || offsets.back() != neighbours.size() || !std::is_sorted(offsets.begin(), offsets.end()))
+            return false;
+        return std::all_of(neighbours.begin(), neighbours.end(),
+                           [&](VertexId n) { return n < cells.size(); });
+    }
+
+    // loads the graph from the cache, or builds it from the map and writes
+    // the cache; true if the cache was used
+    bool LoadCached(const std::string& mapFile, const std::string& cacheFile) {
+        auto key = KeyOf(mapFile);
+        if (LoadBinary(cacheFile, key))
+            return true;
+        Load(MapFile(mapFile));
+        try {
+            SaveBinary(cacheFile, key);
+        } catch (const std::logic_error& e) {
+            std::error_code error;
+            auto temporary = cacheFile + ".tmp";
+            if (std::filesystem::is_regular_file(temporary, error))
+                std::filesystem::remove(temporary, error);
+            WarnCacheNotWritten(e.what());
+        }
+        return false;
+    }
+
+    // position of every vertex, the first vertex of every row and the vertex
+    // of every cell, row by row
+    int height = 0;
+    int width = 0;
+    std::vector< Indices > cells;
+    std::vector< std::uint32_t > rows;
+    std::vector< VertexId > grid;
+
+    std::vector< std::uint32_t > offsets;
+    std::vector< VertexId > neighbours;
+
+    std::vector< int > dist;
+    std::vector< VertexId > prev;
+    std::vector< Handle > handles;
+    std::vector< unsigned char > queued;
+
+    void ResetDistances() {
+        std::fill(dist.begin(), dist.end(), HeapType::Infinity);
+        std::fill(prev.begin(), prev.end(), None);
+        std::fill(queued.begin(), queued.end(), 0);
+    }
+
+    void Dijkstra(VertexId from, VertexId to) {
+        HeapType h;
+
+        dist[from] = 0;
+        for (VertexId v = 0; v < Size(); ++v)
+            handles[v] = h.Insert(dist[v], v);
+
         while (!h.Empty()) {
-            auto min = h.ExtractMin();
-            auto u = min->item;
+            auto u = h.Pop().second;
 
-            if (u->indices == t) {
+            if (u == to) {
                 return;
                 //return ToPathVector(u);
             }
 
-            for (auto v : u->neighbors) {
-                int alt = u->dist+ 1;
-                if (alt < v->dist) {
-                    v->dist = alt;
-                    v->prev = u;
-                    h.DecreaseKey(v->handle, alt);
+            int alt = dist[u] + 1;
+            for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+                auto v = neighbours[e];
+                if (alt < dist[v]) {
+                    dist[v] = alt;
+                    prev[v] = u;
+                    h.DecreaseKey(handles[v], alt);
                 }
             }
         }
         throw std::logic_error("path not found");
     }
 
-    void Dijkstra2(const Vertex& from, const Vertex& to) {
-        auto f = from.indices;
-        auto t = to.indices;
+    void Dijkstra2(VertexId from, VertexId to) {
         HeapType h;
 
-        const_cast< Vertex& >(from).dist = 0;
-
-        std::unordered_map< Handle, Handle > handles;
-
-        h.Insert(0, const_cast< Vertex* >(&from));
+        dist[from] = 0;
+        handles[from] = h.Insert(0, from);
+        queued[from] = 1;
 
         while (!h.Empty()) {
-            auto min = h.ExtractMin();
-            auto u = min->item;
-            u->handle = nullptr;
+            auto u = h.Pop().second;
+            queued[u] = 0;
 
-            if (u->indices == t)
+            if (u == to)
                 return;
 //                return ToPathVector(u);
 
-            for (auto v : u->neighbors) {
-                int alt = u->dist + 1;
-                if (alt < v->dist) {
-                    v->dist = alt;
-                    v->prev = u;
-                    if (auto it = handles.find(v->handle); it != handles.end()) {
-                        h.DecreaseKey(v->handle, alt);
+            int alt = dist[u] + 1;
+            for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+                auto v = neighbours[e];
+                if (alt < dist[v]) {
+                    dist[v] = alt;
+                    prev[v] = u;
+                    if (queued[v]) {
+                        h.DecreaseKey(handles[v], alt);
                     } else {
-                        auto handle = h.Insert(alt, v);
-                        handles[handle] = handle;
+                        handles[v] = h.Insert(alt, v);
+                        queued[v] = 1;
                     }
                 }
             }
@@ -293,16 +455,16 @@ public:
         throw std::logic_error("path not found");
     }
 
-    std::vector< Indices > ToPathVector(const Vertex* u) {
+    std::vector< Indices > ToPathVector(VertexId u) const {
         std::vector< Indices > indices;
-        std::stack< const Vertex* > path;
-        while (u->prev) {
+        std::stack< VertexId > path;
+        while (prev[u] != None) {
             path.push(u);
-            u = u->prev;
+            u = prev[u];
         }
 
-        while (path.empty()) {
-            indices.push_back(path.top()->indices);
+        while (!path.empty()) {
+            indices.push_back(cells[path.top()]);
             path.pop();
         }
 
@@ -311,4 +473,4 @@ public:
 
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <base/HeapBase.hpp>
+
+namespace MC {
+
+// Log-linear histogram of latencies in the manner of HdrHistogram. Values
+// below 2^SubBits are counted exactly, larger ones keep their SubBits highest
+// bits, so a reported percentile is at most 1/2^(SubBits-1) above the real one.
+// Recording is O(1) and the memory does not depend on the number of values.
+class LatencyHistogram {
+    constexpr static unsigned SubBits = 6;
+    constexpr static std::uint64_t Half = std::uint64_t(1) << (SubBits - 1);
+
+    std::vector< std::uint64_t > counts;
+    std::uint64_t total = 0;
+    std::uint64_t max = 0;
+
+    static std::size_t Index(std::uint64_t value) {
+        if (value < 2 * Half)
+            return value;
+        unsigned shift = FloorLog2(value) - (SubBits - 1);
+        return shift * Half + (value >> shift);
+    }
+
+    // largest value counted at index
+    static std::uint64_t Highest(std::size_t index) {
+        if (index < 2 * Half)
+            return index;
+        std::uint64_t shift = index / Half - 1;
+        std::uint64_t sub = index - shift * Half;
+        return ((sub + 1) << shift) - 1;
+    }
+
+public:
+    void Record(std::uint64_t value) {
+        std::size_t i = Index(value);
+        if (i >= counts.size())
+            counts.resize(i + 1, 0);
+        ++counts[i];
+        ++total;
+        max = std::max(max, value);
+    }
+
+    std::uint64_t Count() const {
+        return total;
+    }
+
+    std::uint64_t Max() const {
+        return max;
+    }
+
+    // smallest recorded value v such that a fraction p of the values is <= v
+    std::uint64_t Percentile(double p) const {
+        if (total == 0)
+            return 0;
+
+        auto rank = static_cast< std::uint64_t >(std::ceil(p * total));
+        rank = std::max< std::uint64_t >(rank, 1);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank)
+                return std::min(Highest(i), max);
+        }
+        return max;
+    }
+};
+
+// The latency table of wallclock and latency: one row per heap and
+// operation type with the count, p50, p99, p99.9 and max in ns.
+inline void PrintLatencyHeader(std::ostream& out) {
+    out << std::left << std::setw(32) << "heap" << std::setw(10) << "op" << std::right
+        << std::setw(10) << "count" << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(12) << "max" << std::endl;
+}
+
+inline void PrintLatencyRow(std::ostream& out, const std::string& heap, const std::string& op,
+                            const LatencyHistogram& h) {
+    if (h.Count() == 0)
+        return;
+    out << std::left << std::setw(32) << heap << std::setw(10) << op << std::right
+        << std::setw(10) << h.Count()
+        << std::setw(10) << h.Percentile(0.5)
+        << std::setw(10) << h.Percentile(0.99)
+        << std::setw(10) << h.Percentile(0.999)
+        << std::setw(12) << h.Max() << std::endl;
+}
+
+}
@@ -0,0 +1,141 @@
+#include <ImplicitHeap/dary_heap.hpp>
+#include <ExplicitHeap/explicit_heap.hpp>
+#include <FibonacciHeap/fibonacci_heap.hpp>
+#include <BinomialHeap/binomial_heap.hpp>
+#include <ViolationHeap/violation_heap.hpp>
+#include <RankPairingHeap/rp_heap.hpp>
+#include <PairingHeap/pairing_heap.hpp>
+#include <StrictFibonacciHeap/strict_fibonacci_heap.hpp>
+#include "histogram.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Per-operation latency percentiles. Amortized heaps put off work (lazy
+// roots, unpaired children, cascading cuts) and pay for it in single slow
+// operations, which only shows in the tail, never in the total time.
+// Every run repeats the same operations, and each operation keeps its fastest
+// time, so that preemption and page faults do not pass for a slow operation.
+// The inserts that grow a node pool or an array stay slow in every heap.
+// The fastest times go through the same histogram and table as the latency
+// mode of wallclock.
+
+using Clock = std::chrono::steady_clock;
+
+struct Latencies {
+    std::vector< long long > insert;
+    std::vector< long long > decrease;
+    std::vector< long long > extract;
+};
+
+template < typename F >
+void Time(std::vector< long long >& out, F f) {
+    auto start = Clock::now();
+    f();
+    out.push_back(std::chrono::duration_cast< std::chrono::nanoseconds >(Clock::now() - start).count());
+}
+
+// fills the heap with size keys, then does size rounds of decrease-key,
+// extract-min and insert, so the heap stays about as large
+template < typename Heap >
+Latencies Measure(int size, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution< int > keys(0, 1 << 30);
+
+    Heap heap;
+    Latencies l;
+    l.insert.reserve(2 * size);
+    l.decrease.reserve(size);
+    l.extract.reserve(size);
+    // live ids, and the handle, key and place in live of every id
+    std::vector< int > live;
+    std::vector< typename Heap::Handle > handles;
+    std::vector< int > current;
+    std::vector< std::size_t > slot;
+    handles.reserve(2 * size);
+
+    auto insert = [&](int key) {
+        int id = static_cast< int >(handles.size());
+        current.push_back(key);
+        slot.push_back(live.size());
+        live.push_back(id);
+        typename Heap::Handle h{};
+        Time(l.insert, [&] { h = heap.Insert(key, id); });
+        handles.push_back(h);
+    };
+
+    for (int i = 0; i < size; ++i)
+        insert(keys(rng));
+
+    for (int i = 0; i < size; ++i) {
+        int id = live[rng() % live.size()];
+        int key = heap.Min().key + static_cast< int >(rng() % 1024);
+        if (key < current[id]) {
+            Time(l.decrease, [&] { heap.DecreaseKey(handles[id], key); });
+            current[id] = key;
+        }
+
+        int min = 0;
+        Time(l.extract, [&] { min = heap.Pop().second; });
+        live[slot[min]] = live.back();
+        slot[live.back()] = slot[min];
+        live.pop_back();
+
+        insert(keys(rng));
+    }
+    return l;
+}
+
+void Print(const std::string& name, const std::string& op, const std::vector< long long >& v) {
+    MC::LatencyHistogram h;
+    for (long long t : v)
+        h.Record(static_cast< std::uint64_t >(t));
+    MC::PrintLatencyRow(std::cout, name, op, h);
+}
+
+void KeepFastest(std::vector< long long >& best, const std::vector< long long >& times) {
+    for (std::size_t i = 0; i < best.size(); ++i)
+        best[i] = std::min(best[i], times[i]);
+}
+
+template < typename Heap >
+void Run(int size, int repeats, unsigned seed) {
+    auto l = Measure< Heap >(size, seed);
+    for (int i = 1; i < repeats; ++i) {
+        auto next = Measure< Heap >(size, seed);
+        KeepFastest(l.insert, next.insert);
+        KeepFastest(l.decrease, next.decrease);
+        KeepFastest(l.extract, next.extract);
+    }
+    std::string name = Heap().Name;
+    Print(name, "insert", l.insert);
+    Print(name, "decrease", l.decrease);
+    Print(name, "extract", l.extract);
+}
+
+int main(int argc, char** argv) {
+    int size = argc > 1 ? std::atoi(argv[1]) : 100000;
+    int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+    unsigned seed = std::random_device()();
+
+    std::cout << "Heap size: " << size << ", best of " << repeats << " runs, latencies in ns" << std::endl;
+    MC::PrintLatencyHeader(std::cout);
+
+    Run< MC::DaryHeap< int, 2 > >(size, repeats, seed);
+    Run< MC::ExplicitHeap< int > >(size, repeats, seed);
+    Run< MC::BinomialHeap< int > >(size, repeats, seed);
+    Run< MC::LazyBinomialHeap< int > >(size, repeats, seed);
+    Run< MC::FibonacciHeap< int > >(size, repeats, seed);
+    Run< MC::IncrementalFibonacciHeap< int > >(size, repeats, seed);
+    Run< MC::StrictFibonacciHeap< int > >(size, repeats, seed);
+    Run< MC::ViolationHeap< int > >(size, repeats, seed);
+    Run< MC::RankPairingHeap< int > >(size, repeats, seed);
+    Run< MC::PairingHeap< int > >(size, repeats, seed);
+    return 0;
+}
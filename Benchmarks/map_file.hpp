@@ -0,0 +1,174 @@
+#pragma once
+
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MC {
+
+// read-only mapping of a whole file, through mmap or MapViewOfFile
+class MappedFile {
+    const char* data = nullptr;
+    std::size_t size = 0;
+
+public:
+    MappedFile() = default;
+
+#ifdef _WIN32
+    explicit MappedFile(const std::string& filename) {
+        HANDLE fd = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (fd == INVALID_HANDLE_VALUE)
+            throw std::logic_error("file '" + filename + "' not found");
+
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(fd, &length)) {
+            CloseHandle(fd);
+            throw std::logic_error("cannot stat '" + filename + "'");
+        }
+
+        size = static_cast< std::size_t >(length.QuadPart);
+        if (size > 0) {
+            // the view keeps the file mapped after both handles are closed
+            HANDLE mapping = CreateFileMappingA(fd, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            void* p = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            if (mapping)
+                CloseHandle(mapping);
+            if (!p) {
+                CloseHandle(fd);
+                throw std::logic_error("cannot map '" + filename + "'");
+            }
+            data = static_cast< const char* >(p);
+        }
+        CloseHandle(fd);
+    }
+#else
+    explicit MappedFile(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::logic_error("file '" + filename + "' not found");
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw std::logic_error("cannot stat '" + filename + "'");
+        }
+
+        size = static_cast< std::size_t >(st.st_size);
+        if (size > 0) {
+            void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                close(fd);
+                throw std::logic_error("cannot map '" + filename + "'");
+            }
+            madvise(p, size, MADV_SEQUENTIAL);
+            data = static_cast< const char* >(p);
+        }
+        close(fd);
+    }
+#endif
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& o) noexcept : data(o.data), size(o.size) {
+        o.data = nullptr;
+        o.size = 0;
+    }
+
+    MappedFile& operator=(MappedFile&& o) noexcept {
+        std::swap(data, o.data);
+        std::swap(size, o.size);
+        return *this;
+    }
+
+    ~MappedFile() {
+        if (!data)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        munmap(const_cast< char* >(data), size);
+#endif
+    }
+
+    const char* Data() const { return data; }
+    std::size_t Size() const { return size; }
+};
+
+// A MovingAI .map file read in place: the header is parsed and every row of
+// the grid is a view of the mapping, nothing is copied. Rows are indexed like
+// the rows of a map_t, so Graph loads either.
+class MapFile {
+    MappedFile file;
+    int width = 0;
+    int height = 0;
+    std::vector< std::string_view > rows;
+
+    static std::string_view NextLine(std::string_view& text) {
+        auto end = text.find('\n');
+        auto line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        return line;
+    }
+
+public:
+    MapFile() = default;
+
+    explicit MapFile(const std::string& filename) : file(filename) {
+        std::string_view text(file.Data(), file.Size());
+
+        // type, height and width in any order, up to the "map" line
+        for (;;) {
+            if (text.empty())
+                throw std::logic_error("'" + filename + "' has no map section");
+            auto line = NextLine(text);
+            if (line == "map")
+                break;
+            auto space = line.find(' ');
+            if (space == std::string_view::npos)
+                continue;
+            auto what = line.substr(0, space);
+            int value = std::atoi(std::string(line.substr(space + 1)).c_str());
+            if (what == "height")
+                height = value;
+            else if (what == "width")
+                width = value;
+        }
+
+        rows.reserve(height);
+        while (!text.empty() && static_cast< int >(rows.size()) < height) {
+            auto line = NextLine(text);
+            rows.push_back(line.substr(0, width));
+        }
+    }
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    // the container interface of map_t
+    std::size_t size() const { return rows.size(); }
+    std::string_view operator[](std::size_t row) const { return rows[row]; }
+};
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace MC {
+
+// one (start, goal) query of a MovingAI scenario; x is the column, y the row
+struct Query {
+    int bucket = 0;
+    int startX = 0;
+    int startY = 0;
+    int goalX = 0;
+    int goalY = 0;
+    double optimal = 0;
+};
+
+// a .scen file: a version line, then per line the bucket, map, map width and
+// height, start x and y, goal x and y and the optimal length
+inline std::vector< Query > LoadScenario(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in.is_open())
+        throw std::logic_error("file '" + filename + "' not found");
+
+    std::vector< Query > queries;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 7, "version") == 0)
+            continue;
+
+        std::istringstream ss(line);
+        Query q;
+        std::string map;
+        int width, height;
+        if (ss >> q.bucket >> map >> width >> height >> q.startX >> q.startY >> q.goalX >> q.goalY >> q.optimal)
+            queries.push_back(q);
+    }
+    return queries;
+}
+
+}
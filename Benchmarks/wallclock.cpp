@@ -1,18 +1,26 @@
 
 #include <ImplicitHeap/implicit_heap.hpp>
+#include <ImplicitHeap/dary_heap.hpp>
 #include <ExplicitHeap/explicit_heap.hpp>
 #include <FibonacciHeap/fibonacci_heap.hpp>
 #include <BinomialHeap/binomial_heap.hpp>
 #include <ViolationHeap/violation_heap.hpp>
 #include <RankPairingHeap/rp_heap.hpp>
 #include <RankPairingHeap/rp_heap_t2.hpp>
+#include <PairingHeap/pairing_heap.hpp>
+#include <StrictFibonacciHeap/strict_fibonacci_heap.hpp>
 
+#include <algorithm>
+#include <array>
 #include <functional>
 #include <random>
 #include <chrono>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <map>
+#include <stdexcept>
+#include <string>
 #include "benchmark.hpp"
 
 using std::ofstream;
@@ -23,12 +31,33 @@ using std::chrono::duration_cast;
 
 using TItem = int;
 using Implicit = MC::ImplicitHeap< TItem >;
+using Dary2 = MC::DaryHeap< TItem, 2 >;
+using Dary4 = MC::DaryHeap< TItem, 4 >;
+using Dary8 = MC::DaryHeap< TItem, 8 >;
+using Dary16 = MC::DaryHeap< TItem, 16 >;
 using Explicit = MC::ExplicitHeap< TItem >;
 using Fibonacci = MC::FibonacciHeap< TItem >;
+using IncrementalFibonacci = MC::IncrementalFibonacciHeap< TItem >;
+using StrictFibonacci = MC::StrictFibonacciHeap< TItem >;
 using Binomial = MC::BinomialHeap< TItem >;
+using LazyBinomial = MC::LazyBinomialHeap< TItem >;
 using Violation = MC::ViolationHeap< TItem >;
 using RPHeap1 = MC::RankPairingHeap< TItem >;
 using RPHeap2 = MC::RankPairingHeap2< TItem >;
+using Pairing = MC::PairingHeap< TItem >;
+using MultipassPairing = MC::MultipassPairingHeap< TItem >;
+
+// 200-byte job descriptor; the owner string is longer than the small string
+// buffer, so every copy of a job allocates
+struct Job {
+    int id;
+    std::string owner;
+    std::array< char, 160 > payload;
+
+    explicit Job(int i) : id(i), owner("scheduler/queue/worker-" + std::to_string(i)) {
+        payload.fill(static_cast< char >(i));
+    }
+};
 
 using MC::Benchmark;
 using MC::OP;
@@ -38,6 +67,29 @@ std::random_device r;
 std::mt19937_64 rng(r());
 std::uniform_int_distribution< TItem > uid(-32, 32);
 
+// keys of the generated operations; narrow keys repeat a lot, wide keys
+// hardly ever, ascending ones mimic timer deadlines and descending ones make
+// every insert a new minimum
+std::function< TItem() > NextKey = [] { return uid(rng); };
+
+bool SetKeyDistribution(const std::string& name) {
+    static std::uniform_int_distribution< TItem > wide(0, 1 << 30);
+    static std::uniform_int_distribution< TItem > jitter(0, 64);
+    static TItem clock = 0;
+
+    if (name == "narrow")
+        NextKey = [] { return uid(rng); };
+    else if (name == "wide")
+        NextKey = [] { return wide(rng); };
+    else if (name == "ascending")
+        NextKey = [] { return clock++ + jitter(rng); };
+    else if (name == "descending")
+        NextKey = [] { return -(clock++); };
+    else
+        return false;
+    clock = 0;
+    return true;
+}
 
 std::vector< OP > GenerateRandomSequence(int size) {
     std::vector< OP > operations(size);
@@ -45,7 +97,7 @@ std::vector< OP > GenerateRandomSequence(int size) {
 
         op.op = static_cast< OP::type >((unsigned)uid(rng) % (sizeof(OP::type) - 1));
         op.value = uid(rng);
-        op.key = uid(rng);
+        op.key = NextKey();
     }
     return operations;
 }
@@ -56,7 +108,7 @@ std::vector< OP > GenerateRandomInserts(int size) {
 
         op.op = OP::type::Insert;
         op.value = uid(rng);
-        op.key = uid(rng);
+        op.key = NextKey();
     }
     return operations;
 }
@@ -77,7 +129,7 @@ std::vector< OP > GenerateRandomInsertsDKs(int size) {
 	for (auto& op : operations) {
         op.op = static_cast< OP::type >((unsigned)uid(rng) % (sizeof(OP::type) - 2));
         op.value = uid(rng);
-        op.key = uid(rng);
+        op.key = NextKey();
     }
     return operations;
 }
@@ -89,7 +141,7 @@ std::vector< OP > GenerateDKsWithNewMin(int size) {
         OP op;
         op.op = OP::type::Insert;
         op.value = uid(rng);
-        op.key = std::abs(uid(rng));
+        op.key = std::abs(NextKey());
         operations[i] = op;
     }
     for (int i = half; i < size; ++i) {
@@ -102,8 +154,20 @@ std::vector< OP > GenerateDKsWithNewMin(int size) {
     return operations;
 }
 
+// inserts and decrease-keys, then as many extractions; the lazy heaps pay
+// for the first half all at once
+std::vector< OP > GenerateBurst(int size) {
+    auto operations = GenerateRandomInsertsDKs(size);
+    OP extract;
+    extract.op = OP::type::ExtractMin;
+    operations.insert(operations.end(), size, extract);
+    return operations;
+}
+
 
 std::map< std::string, double > averages;
+// operations in the sequences of the last Run
+std::size_t sequenceLength = 0;
 
 void NormalizeAverages() {
     double min = std::min_element(
@@ -146,40 +210,287 @@ void Log(const std::vector< OP >& ops) {
 template < typename Gen >
 void Run(int runs, int size, Gen g, bool log = false) {
     Benchmark< Implicit > imp;
+    Benchmark< Dary2 > da2;
+    Benchmark< Dary4 > da4;
+    Benchmark< Dary8 > da8;
+    Benchmark< Dary16 > da16;
     Benchmark< Explicit > exp;
     Benchmark< Binomial > bin;
+    Benchmark< LazyBinomial > lbin;
     Benchmark< Fibonacci > fib;
+    Benchmark< IncrementalFibonacci > ifib;
+    Benchmark< StrictFibonacci > sfib;
     Benchmark< Violation > vio;
     Benchmark< RPHeap1 > rp1;
     Benchmark< RPHeap2 > rp2;
+    Benchmark< Pairing > pai;
+    Benchmark< MultipassPairing > mpai;
 
     for (int i = 0; i < runs; ++i) {
         auto seq = g(size);
+        sequenceLength = seq.size();
         if (log)
             Log(seq);
 
         imp.Run(seq);
+        da2.Run(seq);
+        da4.Run(seq);
+        da8.Run(seq);
+        da16.Run(seq);
         exp.Run(seq);
         bin.Run(seq);
+        lbin.Run(seq);
         fib.Run(seq);
+        ifib.Run(seq);
+        sfib.Run(seq);
         vio.Run(seq);
         rp1.Run(seq);
         rp2.Run(seq);
+        pai.Run(seq);
+        mpai.Run(seq);
     }
 
     averages[imp.Name()] = imp.Average();
+    averages[da2.Name()] = da2.Average();
+    averages[da4.Name()] = da4.Average();
+    averages[da8.Name()] = da8.Average();
+    averages[da16.Name()] = da16.Average();
     averages[exp.Name()] = exp.Average();
     averages[bin.Name()] = bin.Average();
+    averages[lbin.Name()] = lbin.Average();
     auto f = fib.Name();
     std::transform(f.begin(), f.end(), f.begin(), [](char c) { return std::tolower(c) ;});
     averages[f] = fib.Average();
+    averages[ifib.Name()] = ifib.Average();
+    averages[sfib.Name()] = sfib.Average();
     averages[rp1.Name()] = rp1.Average();
     averages[rp2.Name()] = rp2.Average();
     averages[vio.Name()] = vio.Average();
+    averages[pai.Name()] = pai.Average();
+    averages[mpai.Name()] = mpai.Average();
+}
+
+
+template < typename Heap >
+void RunLatencies(const std::vector< OP >& sequence) {
+    Benchmark< Heap > b(true);
+    b.Run(sequence);
+    b.PrintLatencies(std::cout);
+}
+
+void RunLatencies(int size) {
+    auto seq = GenerateBurst(size);
+    MC::PrintLatencyHeader(std::cout);
+
+    RunLatencies< Implicit >(seq);
+    RunLatencies< Dary2 >(seq);
+    RunLatencies< Dary4 >(seq);
+    RunLatencies< Explicit >(seq);
+    RunLatencies< Binomial >(seq);
+    RunLatencies< LazyBinomial >(seq);
+    RunLatencies< Fibonacci >(seq);
+    RunLatencies< IncrementalFibonacci >(seq);
+    RunLatencies< StrictFibonacci >(seq);
+    RunLatencies< Violation >(seq);
+    RunLatencies< RPHeap1 >(seq);
+    RunLatencies< RPHeap2 >(seq);
+    RunLatencies< Pairing >(seq);
+    RunLatencies< MultipassPairing >(seq);
+}
+
+
+// times inserting a job for every key with insert(heap, key, id)
+template < typename Heap, typename Insert >
+long long TimeJobs(const std::vector< int >& keys, Insert insert) {
+    Heap heap;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < static_cast< int >(keys.size()); ++i)
+        insert(heap, keys[i], i);
+    return duration_cast< microseconds >(high_resolution_clock::now() - start).count();
+}
+
+template < typename Heap >
+void RunJobs(const std::vector< int >& keys) {
+    auto copy = TimeJobs< Heap >(keys, [](Heap& h, int key, int id) {
+        Job job(id);
+        h.Insert(key, job);
+    });
+    auto move = TimeJobs< Heap >(keys, [](Heap& h, int key, int id) {
+        h.Insert(key, Job(id));
+    });
+    auto emplace = TimeJobs< Heap >(keys, [](Heap& h, int key, int id) {
+        h.Emplace(key, id);
+    });
+
+    std::cout << Heap().Name << ": copy " << copy << " us, move " << move
+              << " us, emplace " << emplace << " us" << std::endl;
+}
+
+void RunJobs(int size) {
+    std::vector< int > keys(size);
+    for (auto& k : keys)
+        k = uid(rng);
+
+    RunJobs< MC::ImplicitHeap< Job > >(keys);
+    RunJobs< MC::DaryHeap< Job, 2 > >(keys);
+    RunJobs< MC::DaryHeap< Job, 4 > >(keys);
+    RunJobs< MC::DaryHeap< Job, 8 > >(keys);
+    RunJobs< MC::DaryHeap< Job, 16 > >(keys);
+    RunJobs< MC::ExplicitHeap< Job > >(keys);
+    RunJobs< MC::BinomialHeap< Job > >(keys);
+    RunJobs< MC::LazyBinomialHeap< Job > >(keys);
+    RunJobs< MC::FibonacciHeap< Job > >(keys);
+    RunJobs< MC::StrictFibonacciHeap< Job > >(keys);
+    RunJobs< MC::ViolationHeap< Job > >(keys);
+    RunJobs< MC::RankPairingHeap< Job > >(keys);
+    RunJobs< MC::RankPairingHeap2< Job > >(keys);
+    RunJobs< MC::PairingHeap< Job > >(keys);
+    RunJobs< MC::MultipassPairingHeap< Job > >(keys);
+}
+
+
+struct Generator {
+    const char* name;
+    std::vector< OP > (*generate)(int);
+};
+
+const std::vector< Generator > generators = {
+    { "random", GenerateRandomSequence },
+    { "sorting", GenerateRandomSorting },
+    { "inserts-dks", GenerateRandomInsertsDKs },
+    { "dks-new-min", GenerateDKsWithNewMin },
+    { "burst", GenerateBurst },
+};
+
+const std::vector< std::string > keyDistributions = { "narrow", "wide", "ascending", "descending" };
+
+// comma separated names, "all" stands for every known one
+std::vector< std::string > ParseList(const char* arg, const std::vector< std::string >& known) {
+    std::vector< std::string > names;
+    std::string list = arg;
+    if (list == "all")
+        return known;
+    std::size_t start = 0;
+    while (start <= list.size()) {
+        auto end = std::min(list.find(',', start), list.size());
+        names.push_back(list.substr(start, end - start));
+        start = end + 1;
+    }
+    for (const auto& n : names) {
+        if (std::find(known.begin(), known.end(), n) == known.end())
+            throw std::invalid_argument("unknown name '" + n + "'");
+    }
+    return names;
 }
 
+// writes the rows as they come, so that a long sweep keeps what it has measured
+class SweepOutput {
+    std::ostream& out;
+    bool json;
+    bool first = true;
+
+public:
+    SweepOutput(std::ostream& out, bool json) : out(out), json(json) {
+        if (json)
+            out << "[" << std::endl;
+        else
+            out << "generator,keys,size,operations,runs,heap,average_us,ns_per_op" << std::endl;
+    }
+
+    ~SweepOutput() {
+        if (json)
+            out << std::endl << "]" << std::endl;
+    }
+
+    void Row(const std::string& generator, const std::string& keys, int size, int runs,
+             const std::string& heap, double micros) {
+        double perOp = sequenceLength ? micros * 1000 / sequenceLength : 0;
+        if (json) {
+            out << (first ? "" : ",\n") << "  {\"generator\": \"" << generator << "\", \"keys\": \"" << keys
+                << "\", \"size\": " << size << ", \"operations\": " << sequenceLength
+                << ", \"runs\": " << runs << ", \"heap\": \"" << heap << "\", \"average_us\": " << micros
+                << ", \"ns_per_op\": " << perOp << "}";
+        } else {
+            out << generator << "," << keys << "," << size << "," << sequenceLength << "," << runs << ","
+                << heap << "," << micros << "," << perOp << std::endl;
+        }
+        out.flush();
+        first = false;
+    }
+};
+
+const char* GetCmdOption(const char** begin, const char** end, const std::string& option) {
+    const char** itr = std::find(begin, end, option);
+    if (itr != end && ++itr != end) {
+        return *itr;
+    }
+    return nullptr;
+}
+
+bool CmdOptionExists(const char** begin, const char** end, const std::string& option) {
+    return std::find(begin, end, option) != end;
+}
 
-int main() {
+// every heap on every generator and key distribution, for the sizes
+// min, 10 min, 100 min, ... up to max; a size gets at most runs runs, and
+// no more than fit in about 10^7 operations
+int Sweep(int argc, const char** argv) {
+    auto option = [&](const std::string& name, const char* fallback) {
+        auto value = GetCmdOption(argv, argv + argc, name);
+        return value ? value : fallback;
+    };
+
+    std::vector< std::string > generatorNames;
+    for (const auto& g : generators)
+        generatorNames.push_back(g.name);
+
+    long long min, max;
+    int runs;
+    std::vector< std::string > gens, keys;
+    std::string format = option("-o", "csv");
+    try {
+        min = std::stoll(option("-min", "100"));
+        max = std::stoll(option("-max", "1000000"));
+        runs = std::stoi(option("-r", "10"));
+        gens = ParseList(option("-g", "all"), generatorNames);
+        keys = ParseList(option("-k", "narrow"), keyDistributions);
+    } catch (const std::exception& e) {
+        std::cerr << "invalid sweep option: " << e.what() << std::endl;
+        return 1;
+    }
+    if (min < 1 || max > 100000000 || min > max || runs < 1 || (format != "csv" && format != "json")) {
+        std::cerr << "Example: \"./wallclock --sweep -min 100 -max 100000000 -r 10 -g sorting,burst "
+                  << "-k narrow,wide -o json -f sweep.json\"" << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (auto name = GetCmdOption(argv, argv + argc, "-f"))
+        file.open(name);
+    SweepOutput out(file.is_open() ? file : std::cout, format == "json");
+
+    for (const auto& k : keys) {
+        SetKeyDistribution(k);
+        for (const auto& name : gens) {
+            auto g = std::find_if(generators.begin(), generators.end(),
+                                  [&](const Generator& gen) { return name == gen.name; });
+            for (long long size = min; size <= max; size *= 10) {
+                int r = static_cast< int >(std::max(1ll, std::min< long long >(runs, 10000000 / size)));
+                std::cerr << name << ", " << k << " keys, size " << size << ", " << r << " runs" << std::endl;
+                averages.clear();
+                Run(r, static_cast< int >(size), g->generate);
+                for (const auto& kv : averages)
+                    out.Row(name, k, static_cast< int >(size), r, kv.first, kv.second);
+            }
+        }
+    }
+    return 0;
+}
+
+
+int main(int argc, const char** argv) {
+    if (CmdOptionExists(argv, argv + argc, "--sweep"))
+        return Sweep(argc, argv);
 
     int runs = 100;
     int sequence_size = 100;
@@ -193,5 +504,13 @@ int main() {
     std::cout << "Normalized average:" << std::endl;
     NormalizeAverages();
     std::cout << "--------------------------------------------------------" << std::endl;
+    int jobs = 100000;
+    std::cout << "Job items (" << sizeof(Job) << " bytes), " << jobs << " inserts:" << std::endl;
+    RunJobs(jobs);
+    std::cout << "--------------------------------------------------------" << std::endl;
+    int burst = 100000;
+    std::cout << "Latency per operation (ns), " << burst << " inserts and decrease-keys, then extractions:" << std::endl;
+    RunLatencies(burst);
+    std::cout << "--------------------------------------------------------" << std::endl;
     return 0;
 }
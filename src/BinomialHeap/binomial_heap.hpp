@@ -1,164 +1,294 @@
 #pragma once
 
-#include <algorithm>
+#include <functional>
 #include <memory>
+#include <type_traits>
 #include <vector>
-#include <functional>
-#include <list>
+#include <utility>
 #include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
 
 namespace MC {
 
-template<typename Item>
+// Insertion policies of BinomialHeap. Eager insertion links trees right away
+// so that no two roots share a degree; lazy insertion only appends a new root
+// and leaves all linking to the next ExtractMin.
+struct EagerInsert {};
+struct LazyInsert {};
+
+template < typename Item, typename Key = int, typename Compare = std::less< Key >, typename Insertion = EagerInsert >
 class BinomialHeap : public HeapBase {
+    constexpr static bool Lazy = std::is_same< Insertion, LazyInsert >::value;
+
     struct Node {
-        int key;
+        Key key;
         Item item;
+        unsigned degree = 0;
 
-        Node* parent = nullptr;
+        // circular list of siblings
+        Node* next = this;
+        Node* prev = this;
 
-        std::list< Node* > children;
+        Node* child = nullptr;
+        Node* parent = nullptr;
 
-        Node(int k, const Item& i) : key(k), item(i) {
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {
         }
 
         void AddChild(Node* n) {
             n->parent = this;
-            children.push_back(n);
+            child = Splice(child, n);
+            ++degree;
         }
 
-        auto FindChild(Node* n) {
-            return std::find(children.begin(), children.end(), n);
-        }
-
-        int Degree() const { return children.size(); }
-
-        ~Node() {
-            for (auto p : children)
-                delete p;
+        bool IsAlone() const {
+            return this == next;
         }
     };
 
-    std::list< Node* > roots;
+    // roots form a circular list as well, entered through any of them
+    Node* roots = nullptr;
+    // root with the smallest key, kept up to date by every operation
+    Node* min = nullptr;
     int count = 0;
+    // roots by degree during consolidation, all null in between; grows only
+    std::vector< Node* > buckets;
+    NodePool< Node > pool;
+    Compare compare;
+
+    // joins two circular lists, either of which may be empty
+    static Node* Splice(Node* a, Node* b) {
+        if (!a)
+            return b;
+        if (!b)
+            return a;
+
+        Node* an = a->next;
+        Node* bp = b->prev;
+        a->next = b;
+        b->prev = a;
+        bp->next = an;
+        an->prev = bp;
+        return a;
+    }
 
-    const Node* MinImpl() const {
-        return *std::min_element(roots.begin(), roots.end(), [](const auto& x, const auto& y) {
-            return x->key < y->key;
-        });
+    // unlinks n from its circular list and returns the rest of it
+    static Node* Unlink(Node* n) {
+        if (n->IsAlone())
+            return nullptr;
+
+        Node* rest = n->next;
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+        n->next = n->prev = n;
+        return rest;
     }
 
 public:
     using NodeType = Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
 
-    BinomialHeap() : HeapBase("binomial heap") {}
+    BinomialHeap() : HeapBase(Lazy ? "lazy binomial heap" : "binomial heap") {}
 
-    bool Empty() const { return roots.empty(); }
+    bool Empty() const { return roots == nullptr; }
 
     const Node& Min() const {
         if (Empty())
             EmptyException();
-        return *MinImpl();
+        return *min;
     }
 
-    const Node* Insert(int key, const Item& item) {
-        auto n = new Node(key, item);
-        roots.push_back(n);
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        auto n = pool.New(key, std::forward< Args >(args)...);
+        roots = Splice(roots, n);
         ++count;
-        if (count >= 1)
+        if (Lazy) {
+            if (!min || compare(n->key, min->key))
+                min = n;
+        } else {
             Consolidate();
+        }
 
         return n;
     }
 
-    void DecreaseKey(const Node* node, int key) {
-        if (key > node->key)
+    void DecreaseKey(const Node* node, Key key) {
+        if (compare(node->key, key))
             InvalidKeyException();
 
         auto x = const_cast< Node* >(node);
         x->key = key;
 
-        while (x->parent && x->key < x->parent->key) {
+        while (x->parent && compare(x->key, x->parent->key)) {
             Swap(x->parent, x);
         }
+
+        if (!x->parent && compare(x->key, min->key))
+            min = x;
     }
 
-    std::unique_ptr< Node > ExtractMin() {
+    NodePtr ExtractMin() {
         if (Empty())
             EmptyException();
 
-        auto min = const_cast< Node* >(MinImpl());
-
-        std::unique_ptr< Node > ret(min);
-        auto it = std::find(roots.begin(), roots.end(), min);
-        roots.erase(it);
+        NodePtr ret = pool.Own(min);
+        roots = Unlink(min);
         --count;
 
-        auto cn = std::move(min->children);
-        for (auto c : cn) {
-            c->parent = nullptr;
-            roots.push_back(c);
+        Node* c = ret->child;
+        if (c) {
+            Node* p = c;
+            do {
+                p->parent = nullptr;
+                p = p->next;
+            } while (p != c);
+            roots = Splice(roots, c);
         }
-        if (roots.empty())
-            min = nullptr;
-        else
+        ret->child = nullptr;
+        ret->degree = 0;
+
+        min = nullptr;
+        if (roots)
             Consolidate();
         return ret;
     }
 
+    std::pair< Key, Item > Pop() {
+        auto top = ExtractMin();
+        return { top->key, std::move(top->item) };
+    }
+
     ~BinomialHeap() {
-        for (auto p : roots)
-            delete p;
+        if (NodePool< Node >::TriviallyDestructible)
+            return;
+        FreeList(roots);
     }
 
 private:
 
+    // destroys the circular list entered through n with all its subtrees
+    void FreeList(Node* n) {
+        if (!n)
+            return;
+
+        n->prev->next = nullptr;
+        while (n) {
+            Node* next = n->next;
+            FreeList(n->child);
+            pool.Delete(n);
+            n = next;
+        }
+    }
+
+    // takes the place of old in its circular list, n must not be linked anywhere
+    static void Replace(Node* old, Node* next, Node* prev, Node* n) {
+        if (next == old) {
+            n->next = n->prev = n;
+            return;
+        }
 
+        n->next = next;
+        n->prev = prev;
+        prev->next = n;
+        next->prev = n;
+    }
 
+    static void Adopt(Node* parent) {
+        Node* c = parent->child;
+        if (!c)
+            return;
+
+        Node* p = c;
+        do {
+            p->parent = parent;
+            p = p->next;
+        } while (p != c);
+    }
+
+    // exchanges the positions of x and its child y
     void Swap(Node* x, Node* y) {
-        auto cxi = x->FindChild(y);
+        Node* xNext = x->next;
+        Node* xPrev = x->prev;
+        Node* yNext = y->next;
+        Node* yPrev = y->prev;
+
+        Replace(x, xNext, xPrev, y);
+        Replace(y, yNext, yPrev, x);
 
         y->parent = x->parent;
-        if (y->parent)
-            *y->parent->FindChild(x) = y;
-        else {
-            auto it = std::find(roots.begin(), roots.end(), x);
-            *it = y;
+        if (y->parent) {
+            if (y->parent->child == x)
+                y->parent->child = y;
+        } else if (roots == x) {
+            roots = y;
         }
-        x->parent = y;
-        *cxi = x;
-        std::for_each(x->children.begin(), x->children.end(), [y](auto p) {p->parent = y; });
-        std::for_each(y->children.begin(), y->children.end(), [x](auto p) {p->parent = x; });
-        std::swap(x->children, y->children);
+
+        Node* yChild = y->child;
+        y->child = x->child == y ? x : x->child;
+        x->child = yChild;
+        std::swap(x->degree, y->degree);
+
+        Adopt(x);
+        Adopt(y);
     }
 
     void Consolidate() {
-        int bound = std::ceil(std::log2(count)) + 1;
-        std::vector< Node* > tmp(bound, nullptr);
-        for (auto x : roots) {
-            auto d = x->Degree();
-            while (tmp[d]) {
-                auto y = tmp[d];
-
-                if (y->key < x->key)
+        // a tree of degree d has 2^d nodes
+        std::size_t bound = FloorLog2(count) + 1;
+        if (buckets.size() < bound)
+            buckets.resize(bound, nullptr);
+
+        roots->prev->next = nullptr;
+        for (Node* x = roots, *next; x; x = next) {
+            next = x->next;
+            x->next = x->prev = x;
+
+            auto d = x->degree;
+            while (buckets[d]) {
+                auto y = buckets[d];
+
+                if (compare(y->key, x->key))
                     std::swap(x, y);
 
                 x->AddChild(y);
-                tmp[d] = nullptr;
+                buckets[d] = nullptr;
                 ++d;
             }
 
-            tmp[d] = x;
+            buckets[d] = x;
         }
 
-        roots.clear();
+        roots = nullptr;
+        min = nullptr;
 
-        for (auto p : tmp) {
+        for (std::size_t d = 0; d < bound; ++d) {
+            auto p = buckets[d];
             if (!p)
                 continue;
-            roots.push_back(p);
+            buckets[d] = nullptr;
+            roots = Splice(roots, p);
+            if (!min || compare(p->key, min->key))
+                min = p;
         }
     }
 };
+
+template < typename Item >
+using LazyBinomialHeap = BinomialHeap< Item, int, std::less< int >, LazyInsert >;
+
 }
 
@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 #include "../../catch/catch.hpp"
 #include "binomial_heap.hpp"
+#include <vector>
 
 using namespace MC;
 using bh = BinomialHeap< int >;
@@ -23,7 +24,7 @@ struct test : protected bh {
     }
 
     auto Ex() {
-        std::unique_ptr< bh::NodeType > ret;
+        bh::NodePtr ret;
         REQUIRE_NOTHROW(ret = std::move(bh::ExtractMin()));
         return ret;
     }
@@ -38,10 +39,10 @@ TEST_CASE("simple insert") {
 
     REQUIRE(p->key == i.key);
 
-    CHECK(p->Degree() == 0);
+    CHECK(p->degree == 0);
     CHECK(p->key == 1);
     CHECK(p->item == 1);
-    CHECK(p->children.empty());
+    CHECK(p->child == nullptr);
     CHECK(p->parent == nullptr);
 }
 //
@@ -78,6 +79,96 @@ TEST_CASE("multiple inserts") {
         REQUIRE(n->parent->key == 0);
     }
 }
+
+TEST_CASE("decrease key") {
+    test t;
+    std::vector< Handle > inserts;
+    for (int i = 0; i < 8; ++i)
+        inserts.push_back(t.Insert(i));
+
+    // a single tree of degree 3 rooted at 0, 7 is a leaf three levels down
+    REQUIRE(t.Min().degree == 3);
+
+    t.DK(inserts.back(), -1);
+    CHECK(inserts.back()->parent == nullptr);
+    CHECK(inserts.back()->degree == 3);
+    CHECK(t.Min().item == 7);
+
+    t.DK(inserts[4], -2);
+    CHECK(t.Min().item == 4);
+
+    std::vector< int > expected = { -2, -1, 0, 1, 2, 3, 5, 6 };
+    for (int k : expected)
+        CHECK(t.Ex()->key == k);
+}
+
+TEST_CASE("cached min") {
+    test t;
+    std::vector< Handle > inserts;
+    for (int i = 10; i < 15; ++i)
+        inserts.push_back(t.Insert(i));
+
+    // 10 - 13 form a tree, 14 is a root on its own
+    t.DK(inserts[3], 11);
+    CHECK(t.Min().key == 10);
+
+    t.DK(inserts[4], 10);
+    CHECK(t.Min().key == 10);
+    CHECK(t.Min().item == 10);
+
+    t.DK(inserts[4], 9);
+    CHECK(t.Min().item == 14);
+
+    t.DK(inserts[2], 5);
+    CHECK(t.Min().item == 12);
+    CHECK(t.Ex()->item == 12);
+    CHECK(t.Min().item == 14);
+    CHECK(t.Ex()->item == 14);
+    CHECK(t.Min().item == 10);
+}
+
+TEST_CASE("lazy insert") {
+    LazyBinomialHeap< int > h;
+    CHECK(h.Name == "lazy binomial heap");
+
+    std::vector< LazyBinomialHeap< int >::Handle > inserts;
+    for (int i = 0; i < 8; ++i)
+        inserts.push_back(h.Insert(7 - i, i));
+
+    // nothing is linked before the first extract
+    for (auto n : inserts)
+        CHECK(n->degree == 0);
+    CHECK(h.Min().item == 7);
+
+    h.DecreaseKey(inserts[2], -1);
+    CHECK(h.Min().item == 2);
+
+    CHECK(h.Pop().second == 2);
+    CHECK(h.Min().item == 7);
+    std::vector< int > expected = { 0, 1, 2, 3, 4, 6, 7 };
+    for (int k : expected)
+        CHECK(h.Pop().first == k);
+    CHECK(h.Empty());
+}
+
+TEST_CASE("extract") {
+    test t;
+    for (int i = 0; i < 100; ++i)
+        t.Insert((i * 37) % 100);
+
+    for (int i = 0; i < 50; ++i) {
+        auto n = t.Ex();
+        CHECK(n->key == i);
+        CHECK(n->child == nullptr);
+    }
+
+    for (int i = 0; i < 10; ++i)
+        t.Insert(i);
+    for (int i = 0; i < 10; ++i)
+        CHECK(t.Ex()->key == i);
+    for (int i = 50; i < 100; ++i)
+        CHECK(t.Ex()->key == i);
+}
 //
 //
 //    INFO("3 elements") {
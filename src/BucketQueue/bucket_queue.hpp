@@ -0,0 +1,230 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
+
+namespace MC {
+
+// Circular bucket queue (Dial) for monotone integer keys: no key may be
+// smaller than the last extracted minimum. Keys less than span above that
+// minimum get a bucket of their own, so insert, decrease-key and extract are
+// O(1) apart from skipping empty buckets. Keys further away, such as the
+// infinite distances of unreached vertices, wait in an overflow list until
+// the minimum catches up with them.
+template < typename Item, typename Key = int >
+class BucketQueue : public HeapBase {
+    static_assert(std::is_integral< Key >::value, "bucket queue needs integer keys");
+
+    using Bits = typename std::make_unsigned< Key >::type;
+
+    struct Node {
+        Key key;
+        Item item;
+
+        // doubly-linked list of a bucket or of the overflow
+        Node* next = nullptr;
+        Node* prev = nullptr;
+        bool overflow = false;
+
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
+    };
+
+    std::vector< Node* > buckets;
+    Bits mask;
+    Node* overflow = nullptr;
+    // no key in the overflow is smaller
+    Key overflowFloor = std::numeric_limits< Key >::max();
+    std::size_t inBuckets = 0;
+    std::size_t count = 0;
+    // key of the last extracted minimum, the base the buckets are laid out from
+    Key last = std::numeric_limits< Key >::min();
+    Node* min = nullptr;
+    NodePool< Node > pool;
+
+    static std::size_t RoundUp(std::size_t span) {
+        std::size_t size = 1;
+        while (size < span)
+            size *= 2;
+        return size;
+    }
+
+    Node*& Bucket(Key key) {
+        return buckets[ToBits(key) & mask];
+    }
+
+    static void PushFront(Node*& head, Node* n) {
+        n->prev = nullptr;
+        n->next = head;
+        if (head)
+            head->prev = n;
+        head = n;
+    }
+
+    static void Unlink(Node*& head, Node* n) {
+        if (n->prev)
+            n->prev->next = n->next;
+        else
+            head = n->next;
+        if (n->next)
+            n->next->prev = n->prev;
+        n->next = n->prev = nullptr;
+    }
+
+    void Push(Node* n) {
+        if (ToBits(n->key) - ToBits(last) <= mask) {
+            n->overflow = false;
+            PushFront(Bucket(n->key), n);
+            ++inBuckets;
+        } else {
+            n->overflow = true;
+            PushFront(overflow, n);
+            if (n->key < overflowFloor)
+                overflowFloor = n->key;
+        }
+    }
+
+    void Remove(Node* n) {
+        if (n->overflow) {
+            Unlink(overflow, n);
+        } else {
+            Unlink(Bucket(n->key), n);
+            --inBuckets;
+        }
+    }
+
+    // moves the overflow nodes that came within span of the minimum to buckets
+    void Refill() {
+        Node* n = overflow;
+        overflow = nullptr;
+        overflowFloor = std::numeric_limits< Key >::max();
+        while (n) {
+            Node* next = n->next;
+            Push(n);
+            n = next;
+        }
+    }
+
+    Node* FindMin() {
+        Node* m = nullptr;
+        if (inBuckets) {
+            for (Bits b = ToBits(last);; ++b) {
+                if (Node* head = buckets[b & mask]) {
+                    m = head;
+                    break;
+                }
+            }
+        }
+
+        if (overflow && (!m || overflowFloor < m->key)) {
+            Node* o = overflow;
+            for (Node* n = overflow->next; n; n = n->next) {
+                if (n->key < o->key)
+                    o = n;
+            }
+            overflowFloor = o->key;
+            if (!m || o->key < m->key)
+                m = o;
+        }
+        return m;
+    }
+
+    void FreeList(Node* n) {
+        while (n) {
+            Node* next = n->next;
+            pool.Delete(n);
+            n = next;
+        }
+    }
+
+public:
+    using NodeType = Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
+
+    // span bounds the distance of bucketed keys from the minimum; for Dijkstra
+    // it should exceed the largest edge weight. It is rounded up to a power of 2.
+    explicit BucketQueue(std::size_t span = 1024)
+            : HeapBase("bucket queue"), buckets(RoundUp(span), nullptr), mask(RoundUp(span) - 1) {}
+
+    ~BucketQueue() {
+        if (NodePool< Node >::TriviallyDestructible)
+            return;
+        for (Node* head : buckets)
+            FreeList(head);
+        FreeList(overflow);
+    }
+
+    bool Empty() const {
+        return count == 0;
+    }
+
+    const Node& Min() const {
+        if (!min)
+            EmptyException();
+        return *min;
+    }
+
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        CheckMonotone(key, last);
+
+        auto n = pool.New(key, std::forward< Args >(args)...);
+        Push(n);
+        ++count;
+        if (!min || key < min->key)
+            min = n;
+        return n;
+    }
+
+    void DecreaseKey(const Node* node, Key key) {
+        if (node->key < key)
+            InvalidKeyException();
+        CheckMonotone(key, last);
+
+        auto n = const_cast< Node* >(node);
+        Remove(n);
+        n->key = key;
+        Push(n);
+
+        if (key < min->key)
+            min = n;
+    }
+
+    NodePtr ExtractMin() {
+        if (!min)
+            EmptyException();
+
+        Node* n = min;
+        Remove(n);
+        --count;
+        last = n->key;
+        if (n->overflow)
+            Refill();
+
+        min = FindMin();
+        return pool.Own(n);
+    }
+
+    std::pair< Key, Item > Pop() {
+        auto top = ExtractMin();
+        return { top->key, std::move(top->item) };
+    }
+};
+
+}
@@ -0,0 +1,93 @@
+#define CATCH_CONFIG_MAIN
+
+#include "../../catch/catch.hpp"
+#include "bucket_queue.hpp"
+#include "../helpers/random_operations.hpp"
+#include <vector>
+
+using bq = MC::BucketQueue< int >;
+
+TEST_CASE("Insert") {
+    bq h;
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.Min());
+
+    h.Insert(5, 5);
+    auto n = h.Insert(3, 3);
+    h.Insert(bq::Infinity, 8);
+    CHECK(&h.Min() == n);
+    CHECK(h.Name == "bucket queue");
+}
+
+TEST_CASE("ExtractMin") {
+    bq h(8);
+    std::vector< int > keys = { 7, 0, 7, 1024, 3, 2, 2, 20, 1 };
+    for (int k : keys)
+        h.Insert(k, k);
+
+    std::vector< int > expected = { 0, 1, 2, 2, 3, 7, 7, 20, 1024 };
+    for (int k : expected) {
+        auto n = h.ExtractMin();
+        CHECK(n->key == k);
+    }
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.ExtractMin());
+}
+
+TEST_CASE("DecreaseKey") {
+    bq h(4);
+    std::vector< bq::Handle > handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(h.Insert(bq::Infinity, i));
+
+    h.DecreaseKey(handles[4], 0);
+    CHECK(h.Min().item == 4);
+    CHECK(h.Pop().first == 0);
+
+    SECTION("within span") {
+        h.DecreaseKey(handles[7], 2);
+        h.DecreaseKey(handles[2], 1);
+        h.DecreaseKey(handles[7], 1);
+        REQUIRE_THROWS(h.DecreaseKey(handles[2], 3));
+
+        CHECK(h.Pop().first == 1);
+        CHECK(h.Pop().first == 1);
+        CHECK(h.Min().key == bq::Infinity);
+    }
+
+    SECTION("beyond span") {
+        h.DecreaseKey(handles[1], 3);
+        h.DecreaseKey(handles[2], 40);
+        h.DecreaseKey(handles[3], 30);
+        h.DecreaseKey(handles[2], 35);
+
+        std::vector< int > expected = { 3, 30, 35 };
+        for (int k : expected)
+            CHECK(h.Pop().first == k);
+        for (int i = 0; i < 6; ++i)
+            CHECK(h.Pop().first == bq::Infinity);
+        CHECK(h.Empty());
+    }
+}
+
+TEST_CASE("Monotonicity") {
+#ifndef NDEBUG
+    bq h;
+    auto n = h.Insert(10, 0);
+    h.Insert(20, 1);
+    h.Pop();
+
+    REQUIRE_THROWS(h.Insert(5, 2));
+    h.Insert(10, 3);
+    REQUIRE_THROWS(h.DecreaseKey(n, 9));
+#endif
+}
+
+TEST_CASE("Random") {
+    SECTION("keys within span") {
+        helpers::RandomOperations< bq >(11, 20000, helpers::MonotoneKeys(64, -100), 64);
+    }
+    SECTION("keys beyond span") {
+        helpers::RandomOperations< bq >(11, 20000, helpers::MonotoneKeys(200, -100), 16);
+    }
+}
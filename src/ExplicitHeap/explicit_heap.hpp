@@ -3,14 +3,16 @@
 #include <memory>
 #include <cmath>
 #include <functional>
+#include <utility>
 #include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
 
 namespace MC {
 
-template < typename Item >
+template < typename Item, typename Key = int, typename Compare = std::less< Key > >
 class ExplicitHeap : public HeapBase {
     struct Node {
-        int key;
+        Key key;
         Item item;
 
         Node* parent = nullptr;
@@ -18,12 +20,9 @@ class ExplicitHeap : public HeapBase {
         Node* left = nullptr;
         Node* right = nullptr;
 
-        Node(int k, const Item& i) : key(k), item(i) {}
-
-        ~Node() {
-            delete left;
-            delete right;
-        }
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
 
         bool IsRightChild() const {
             if (!parent)
@@ -41,15 +40,15 @@ class ExplicitHeap : public HeapBase {
 
     Node* root = nullptr;
     Node* last = nullptr;
+    NodePool< Node > pool;
+    Compare compare;
 
 
-    void InsertRoot(int key, const Item &item) {
-        last = root = new Node(key, item);
+    void InsertRoot(Node* n) {
+        last = root = n;
     }
 
-    void InsertChild(int key, const Item &item) {
-        auto n = new Node(key, item);
-
+    void InsertChild(Node* n) {
         Node* cur = last;
         while (cur != root && cur->IsRightChild()) {
             cur = cur->parent;
@@ -111,16 +110,16 @@ class ExplicitHeap : public HeapBase {
     }
 
     Node* HeapifyUp(Node* cur) {
-        while (cur != root && cur->key < cur->parent->key) {
+        while (cur != root && compare(cur->key, cur->parent->key)) {
             cur = Swap(cur->parent, cur);
         }
         return cur;
     }
 
-    std::unique_ptr< Node > DeleteLast() {
+    typename NodePool< Node >::Ptr DeleteLast() {
         Node* cur = last;
 
-        std::unique_ptr< Node > ret(last);
+        NodePtr ret = pool.Own(last);
 
         if (cur == root)  {
             root = last = nullptr;
@@ -149,16 +148,25 @@ class ExplicitHeap : public HeapBase {
         return ret;
     }
 
+    // destroys n together with its subtree
+    void Free(Node* n) {
+        if (!n)
+            return;
+        Free(n->left);
+        Free(n->right);
+        pool.Delete(n);
+    }
+
     void HeapifyDown(Node* n) {
         if (!n)
             return;
 
         Node* smallest = n;
 
-        if (n->left && n->left->key < n->key)
+        if (n->left && compare(n->left->key, n->key))
             smallest = n->left;
 
-        if (n->right && n->right->key < smallest->key)
+        if (n->right && compare(n->right->key, smallest->key))
             smallest = n->right;
 
         if (smallest != n) {
@@ -171,15 +179,41 @@ class ExplicitHeap : public HeapBase {
 
 public:
     using NodeType = Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
 
     ExplicitHeap() : HeapBase("binary (explicit) heap") {}
 
+    // nodes live in the pool's arena, whose address survives the move, so
+    // handles and extracted nodes stay valid in the moved-to heap
+    ExplicitHeap(ExplicitHeap&& o) noexcept
+        : HeapBase(o.Name),
+          root(std::exchange(o.root, nullptr)),
+          last(std::exchange(o.last, nullptr)),
+          pool(std::move(o.pool)),
+          compare(std::move(o.compare)) {}
+
+    ExplicitHeap& operator=(ExplicitHeap&& o) noexcept {
+        if (this == &o)
+            return *this;
+        if (!NodePool< Node >::TriviallyDestructible)
+            Free(root);
+        root = std::exchange(o.root, nullptr);
+        last = std::exchange(o.last, nullptr);
+        pool = std::move(o.pool);
+        compare = std::move(o.compare);
+        return *this;
+    }
+
     bool Empty() const {
         return root == nullptr;
     }
 
     ~ExplicitHeap() {
-        delete root;
+        if (!NodePool< Node >::TriviallyDestructible)
+            Free(root);
     }
 
     const Node& Min() const {
@@ -188,27 +222,37 @@ public:
         return *root;
     }
 
-    const Node* Insert(int key, const Item& item) {
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        auto n = pool.New(key, std::forward< Args >(args)...);
         if (!root) {
-            InsertRoot(key, item);
+            InsertRoot(n);
             return root;
         }
 
-        InsertChild(key, item);
+        InsertChild(n);
         return HeapifyUp(last);
     }
 
-    void DecreaseKey(const Node* node, int key) {
+    void DecreaseKey(const Node* node, Key key) {
         auto n = const_cast< Node* >(node);
 
-        if (key > n->key)
+        if (compare(n->key, key))
             InvalidKeyException();
 
         n->key = key;
         HeapifyUp(n);
     }
 
-    std::unique_ptr< Node > ExtractMin() {
+    NodePtr ExtractMin() {
         if (!root)
             EmptyException();
 
@@ -242,14 +286,19 @@ public:
 
         return ret;
     }
+
+    std::pair< Key, Item > Pop() {
+        auto min = ExtractMin();
+        return { min->key, std::move(min->item) };
+    }
 };
 
 
-template < typename T >
-std::vector< T > preorder(const ExplicitHeap< T >& h) {
-    std::vector< T > v;
+template < typename Item, typename Key, typename Compare >
+std::vector< Key > preorder(const ExplicitHeap< Item, Key, Compare >& h) {
+    std::vector< Key > v;
 
-    std::function< void(const typename ExplicitHeap< T >::NodeType&) > pre;
+    std::function< void(const typename ExplicitHeap< Item, Key, Compare >::NodeType&) > pre;
     pre = [&v, &pre](const auto& n) -> void {
         v.push_back(n.key);
         if (n.left)
@@ -102,6 +102,42 @@ TEST_CASE("Reversed - extract") {
 }
 //
 
+TEST_CASE("Pop") {
+    auto h = generate_min_heap(5, vector_t::reversed);
+
+    auto min = h.Pop();
+    CHECK(min.first == 0);
+    CHECK(min.second == 0);
+    Equals(h, {1, 2, 4, 3});
+}
+
+TEST_CASE("Generic keys") {
+    MC::ExplicitHeap< int, double, std::greater< double > > h;
+    std::vector< const decltype(h)::NodeType* > v;
+    for (int i = 0; i < 10; ++i)
+        v.push_back(h.Insert(i / 2.0, i));
+
+    h.DecreaseKey(v[0], 10);
+    CHECK(h.Pop().second == 0);
+    CHECK(h.Pop().first == 4.5);
+    CHECK(h.Pop().first == 4.0);
+}
+
+TEST_CASE("Move keeps extracted nodes valid") {
+    auto h = generate_min_heap(5, vector_t::reversed);
+    auto min = h.ExtractMin();
+
+    min_heap moved(std::move(h));
+    CHECK(moved.Pop().first == 1);
+
+    min_heap assigned;
+    assigned.Insert(7, 7);
+    assigned = std::move(moved);
+    CHECK(assigned.Pop().first == 2);
+    CHECK(min->key == 0);
+    min.reset();
+}
+
 TEST_CASE("SEGFAULT") {
     min_heap h;
     std::vector< const min_heap::NodeType* > v;
@@ -1,8 +1,11 @@
 #define CATCH_CONFIG_MAIN
 
+#include <memory>
 #include <random>
+#include <vector>
 #include "../../catch/catch.hpp"
 #include "fibonacci_heap.hpp"
+#include "../helpers/random_operations.hpp"
 
 
 using fibonacci_heap = MC::FibonacciHeap< int >;
@@ -38,11 +41,64 @@ TEST_CASE("extract") {
         f.Insert(i, i);
     }
     for (int i = 0; i < 4; ++i) {
-        std::unique_ptr< fibonacci_heap::NodeType > r;
+        fibonacci_heap::NodePtr r;
         REQUIRE_NOTHROW(r = f.ExtractMin());
         CHECK(r->key == i);
     }
 }
+TEST_CASE("pop") {
+    MC::FibonacciHeap< std::string > f;
+    for (int i = 3; i >= 0; --i) {
+        f.Insert(i, std::to_string(i));
+    }
+    for (int i = 0; i < 4; ++i) {
+        auto p = f.Pop();
+        CHECK(p.first == i);
+        CHECK(p.second == std::to_string(i));
+    }
+    REQUIRE(f.Empty());
+}
+
+TEST_CASE("emplace") {
+    MC::FibonacciHeap< std::unique_ptr< std::string > > f;
+    f.Insert(2, std::make_unique< std::string >("two"));
+    f.Emplace(1, new std::string("one"));
+    f.Emplace(3, new std::string(3, 'x'));
+
+    CHECK(*f.Pop().second == "one");
+    CHECK(*f.Pop().second == "two");
+    CHECK(*f.Min().item == "xxx");
+}
+
+TEST_CASE("generic keys") {
+    SECTION("uint64_t timestamps") {
+        MC::FibonacciHeap< int, std::uint64_t > f;
+        std::uint64_t base = std::uint64_t(1) << 40;
+        for (int i = 0; i < 10; ++i)
+            f.Insert(base + 10 - i, i);
+
+        CHECK(f.Pop().first == base + 1);
+        CHECK(decltype(f)::Infinity == std::numeric_limits< std::uint64_t >::max());
+    }
+
+    SECTION("greater") {
+        MC::FibonacciHeap< int, int, std::greater< int > > f;
+        std::vector< const decltype(f)::NodeType* > inserted;
+        for (int i = 0; i < 10; ++i)
+            inserted.push_back(f.Insert(i, i));
+
+        f.Pop();
+        f.DecreaseKey(inserted[3], 20);
+        REQUIRE_THROWS(f.DecreaseKey(inserted[4], 0));
+
+        CHECK(f.Pop().second == 3);
+        for (int i = 8; i >= 0; --i) {
+            if (i != 3)
+                CHECK(f.Pop().first == i);
+        }
+    }
+}
+
 TEST_CASE("kyssery") {
     fibonacci_heap f;
     std::random_device r;
@@ -87,3 +143,29 @@ TEST_CASE("kyssery") {
     }
 }
 
+
+TEST_CASE("incremental consolidation") {
+    using incremental = MC::IncrementalFibonacciHeap< int >;
+    CHECK(incremental().Name == "incremental Fibonacci heap");
+
+    SECTION("burst of inserts") {
+        incremental f;
+        std::vector< incremental::Handle > inserted;
+        for (int i = 0; i < 1000; ++i)
+            inserted.push_back(f.Insert((i * 7919) % 1000, i));
+
+        // the keys are a permutation of 0..999, key 190 becomes -1
+        f.DecreaseKey(inserted[10], -1);
+        CHECK(f.Min().item == 10);
+        for (int i = -1; i < 1000; ++i) {
+            if (i == 190)
+                continue;
+            CHECK(f.Pop().first == i);
+        }
+        CHECK(f.Empty());
+    }
+
+    SECTION("random operations") {
+        helpers::RandomOperations< incremental >(7, 20000, helpers::UniformKeys{ 100, 10 });
+    }
+}
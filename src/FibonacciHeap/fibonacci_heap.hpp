@@ -1,22 +1,39 @@
 #pragma once
 
-#include <cmath>
+#include <functional>
 #include <list>
 #include <memory>
 #include <vector>
 #include <optional>
+#include <utility>
 
 #include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
 
 namespace MC {
 
-template < typename Item >
-class BinomialHeap;
+// Consolidation policies of FibonacciHeap. Full consolidation links the whole
+// root list in every ExtractMin, so the first extraction after n inserts is
+// O(n). Incremental consolidation pays as it goes: an operation that adds a
+// root (insert, cut, child of an extracted minimum) spends at most Steps moves
+// or links on consolidating, which is enough to keep the unconsolidated roots
+// few, so that an extraction scans only O(log n) roots.
+struct FullConsolidation {
+    constexpr static unsigned Steps = 0;
+};
 
-template < typename Item >
+template < unsigned N = 4 >
+struct IncrementalConsolidation {
+    static_assert(N > 0, "incremental consolidation needs at least one step");
+    constexpr static unsigned Steps = N;
+};
+
+template < typename Item, typename Key = int, typename Compare = std::less< Key >, typename Consolidation = FullConsolidation >
 class FibonacciHeap : public HeapBase {
+    constexpr static bool Incremental = Consolidation::Steps > 0;
+
     struct Node {
-        int key;
+        Key key;
         Item item;
         unsigned degree = 0;
         bool mark = false;
@@ -27,8 +44,9 @@ class FibonacciHeap : public HeapBase {
         Node* child = nullptr;
         Node* parent = nullptr;
 
-        Node(int k, const Item& i)
-                : key(k), item(i) {}
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
 
         void ResetAll() {
             ResetSiblings();
@@ -68,28 +86,31 @@ class FibonacciHeap : public HeapBase {
         bool IsAlone() const {
             return this == next;
         }
-
-        ~Node() {
-            if (child) {
-                auto act = child;
-                do {
-                    auto next = act->next;
-                    delete act;
-                    act = next;
-                } while (act != child);
-            }
-        }
     };
 
     Node* _min = nullptr;
     unsigned _count = 0;
     unsigned _root_size = 0;
+    // roots by degree during consolidation, all null in between; grows only.
+    // Incremental consolidation keeps its consolidated roots there instead,
+    // while new roots wait in _pending and _carry is the tree being moved.
+    std::vector< Node* > _buckets;
+    Node* _pending = nullptr;
+    Node* _carry = nullptr;
+    // consolidation steps earned by the roots added so far
+    std::size_t _credit = 0;
+    NodePool< Node > _pool;
+    Compare _compare;
 
 public:
 
     using NodeType = FibonacciHeap::Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
 
-    FibonacciHeap() : HeapBase("Fibonacci heap") {}
+    FibonacciHeap() : HeapBase(Incremental ? "incremental Fibonacci heap" : "Fibonacci heap") {}
 
     bool Empty() const {
         return _count == 0;
@@ -102,22 +123,35 @@ public:
         return *_min;
     }
 
-    const Node* Insert(int key, const Item& item) {
-        auto n = new Node(key, item);
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        auto n = _pool.New(key, std::forward< Args >(args)...);
         ++_count;
 
         _add_to_root(n);
+        if (Incremental)
+            _consolidate_steps();
 
         return n;
     }
 
-    std::unique_ptr< Node > ExtractMin() {
+    NodePtr ExtractMin() {
         if (!_min)
              EmptyException();
+        if (Incremental)
+            return _extract_min_incremental();
 
         _move_children_to_root(_min);
         _min->Remove();
-        std::unique_ptr< Node > ret(_min);
+        NodePtr ret = _pool.Own(_min);
 
         --_root_size;
         if (_root_size == 0) {
@@ -132,24 +166,31 @@ public:
 
     }
 
-    void DecreaseKey(const Node* node, int k) {
+    std::pair< Key, Item > Pop() {
+        auto min = ExtractMin();
+        return { min->key, std::move(min->item) };
+    }
+
+    void DecreaseKey(const Node* node, Key k) {
         auto x = const_cast< Node* >(node);
 
-        if (k > x->key)
+        if (_compare(x->key, k))
             InvalidKeyException();
 
         x->key = k;
         Node* y = x->parent;
-        if (y && x->key < y->key) {
+        if (y && _compare(x->key, y->key)) {
             _cut(x, y);
             _cascading_cut(y);
         }
-        if (x->key < _min->key)
+        if (_compare(x->key, _min->key))
             _min = x;
+        if (Incremental)
+            _consolidate_steps();
     }
 
     ~FibonacciHeap() {
-        if (!_min)
+        if (!_min || NodePool< Node >::TriviallyDestructible)
             return;
         _clear();
     }
@@ -157,34 +198,120 @@ public:
 
 protected:
 
-    template <typename > friend class BinomialHeap;
     FibonacciHeap(const std::string& derived) : HeapBase(derived) {}
 
     void _consolidate() {
-        unsigned bound = std::ceil(std::log2(_count) + 1);
-        std::vector< Node* > array(bound, nullptr);
+        // degrees stay below log_phi(n) < 1.5 * log2(n)
+        std::size_t bound = (FloorLog2(_count) + 1) * 3 / 2 + 1;
+        if (_buckets.size() < bound)
+            _buckets.resize(bound, nullptr);
         Node* actual = _min;
         for (;_root_size > 0; --_root_size) {
             auto x = actual;
             auto n = x->next;
             unsigned d = x->degree;
 
-            while (array[d] != nullptr) {
-                Node* y = array[d];
-                if (x->key > y->key)
+            while (_buckets[d] != nullptr) {
+                Node* y = _buckets[d];
+                if (_compare(y->key, x->key))
                     std::swap(x, y);
                 _fib_heap_link(y, x);
-                array[d] = nullptr;
+                _buckets[d] = nullptr;
                 ++d;
             }
 
-            array[d] = x;
+            _buckets[d] = x;
             actual = n;
         }
 
         _min = nullptr;
-        for (auto r : array)
-            _add_to_root(r);
+        for (std::size_t d = 0; d < bound; ++d) {
+            _add_to_root(_buckets[d]);
+            _buckets[d] = nullptr;
+        }
+    }
+
+    NodePtr _extract_min_incremental() {
+        Node* m = _min;
+        if (m == _carry) {
+            _carry = nullptr;
+        } else if (m->degree < _buckets.size() && _buckets[m->degree] == m) {
+            _buckets[m->degree] = nullptr;
+        } else {
+            if (_pending == m)
+                _pending = m->IsAlone() ? nullptr : m->next;
+            m->Remove();
+            --_root_size;
+        }
+
+        _min = nullptr;
+        Node* p = m->child;
+        for (unsigned i = 0; i < m->degree; ++i) {
+            Node* next = p->next;
+            p->parent = nullptr;
+            _add_to_root(p);
+            p = next;
+        }
+
+        NodePtr ret = _pool.Own(m);
+        --_count;
+        ret->ResetAll();
+
+        _min = _find_min();
+        _consolidate_steps();
+        return ret;
+    }
+
+    // moves pending roots into the buckets, one move or link per credit
+    void _consolidate_steps() {
+        for (; _credit > 0; --_credit) {
+            if (!_carry) {
+                if (!_pending) {
+                    _credit = 0;
+                    return;
+                }
+                _carry = _pending;
+                _pending = _carry->IsAlone() ? nullptr : _carry->next;
+                _carry->Remove();
+                _carry->ResetSiblings();
+                --_root_size;
+            }
+
+            unsigned d = _carry->degree;
+            if (d >= _buckets.size())
+                _buckets.resize(d + 1, nullptr);
+
+            Node* y = _buckets[d];
+            if (!y) {
+                _buckets[d] = _carry;
+                _carry = nullptr;
+                continue;
+            }
+
+            // on equal keys the cached minimum must stay a root
+            Node* x = _carry;
+            if (_compare(y->key, x->key) || y == _min)
+                std::swap(x, y);
+            _fib_heap_link(y, x);
+            _buckets[d] = nullptr;
+            _carry = x;
+        }
+    }
+
+    Node* _find_min() const {
+        Node* m = _carry;
+        for (Node* b : _buckets) {
+            if (b && (!m || _compare(b->key, m->key)))
+                m = b;
+        }
+        if (Node* p = _pending) {
+            do {
+                if (!m || _compare(p->key, m->key))
+                    m = p;
+                p = p->next;
+            } while (p != _pending);
+        }
+        return m;
     }
 
     void _fib_heap_link(Node* y, Node* x) {
@@ -219,6 +346,11 @@ protected:
         if (y->degree == 0) {
             y ->child = nullptr;
         }
+        if (Incremental && !y->parent && y->degree + 1 < _buckets.size() && _buckets[y->degree + 1] == y) {
+            // a consolidated root no longer fits its bucket
+            _buckets[y->degree + 1] = nullptr;
+            _add_to_root(y);
+        }
 
         _add_to_root(x);
         x->parent = nullptr;
@@ -238,27 +370,73 @@ protected:
     }
 
     void _clear() {
+        if (Incremental) {
+            if (_pending) {
+                _pending->prev->next = nullptr;
+                for (Node* p = _pending, *next; p; p = next) {
+                    next = p->next;
+                    _free(p);
+                }
+            }
+            for (Node* b : _buckets) {
+                if (b)
+                    _free(b);
+            }
+            if (_carry)
+                _free(_carry);
+            _count = 0;
+            return;
+        }
+
         auto act = _min;
         for (; _root_size; --_root_size) {
             auto n = act->next;
-            delete act;
+            _free(act);
             act = n;
         }
         _count = 0;
     }
 
+    // destroys n together with its subtree
+    void _free(Node* n) {
+        if (n->child) {
+            auto act = n->child;
+            do {
+                auto next = act->next;
+                _free(act);
+                act = next;
+            } while (act != n->child);
+        }
+        _pool.Delete(n);
+    }
+
     void _add_to_root(Node* n) {
         if (!n)
             return;
         ++_root_size;
         n->ResetSiblings();
+        if (Incremental) {
+            _credit += Consolidation::Steps;
+            if (_pending)
+                _pending->AddSibling(n);
+            else
+                _pending = n;
+            if (!_min || _compare(n->key, _min->key))
+                _min = n;
+            return;
+        }
+
         if (!_min) {
             _min = n;
         } else {
             _min->AddSibling(n);
-            if (n->key < _min->key)
+            if (_compare(n->key, _min->key))
                 _min = n;
         }
     }
 };
+
+template < typename Item >
+using IncrementalFibonacciHeap = FibonacciHeap< Item, int, std::less< int >, IncrementalConsolidation<> >;
+
 }
\ No newline at end of file
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "../base/HeapBase.hpp"
+#include "min_child.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace MC {
+
+// D-ary implicit heap without per-node allocations. The heap is kept as two
+// parallel arrays of keys and slots, so the D siblings of a level are
+// contiguous keys; items live in a side table of slots whose indices are
+// handed out as stable handles.
+template < typename Item, unsigned D, typename Key = int, typename Compare = std::less< Key > >
+class DaryHeap : public HeapBase {
+    static_assert(D >= 2, "heap arity must be at least 2");
+
+public:
+    using Handle = std::size_t;
+
+    struct Node {
+        Key key;
+        Item item;
+
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
+    };
+
+private:
+    // the node is built in place, so slots of a freed handle are reused
+    // without requiring Item to be assignable
+    struct Slot {
+        std::optional< Node > node;
+        std::size_t index = 0;
+    };
+
+    std::vector< Key > keys;
+    std::vector< Handle > handles;
+    std::vector< Slot > slots;
+    std::vector< Handle > freed;
+    Compare compare;
+
+
+    static std::size_t ParentIndex(std::size_t index) { return (index - 1) / D; }
+
+    static std::size_t FirstChildIndex(std::size_t index) { return index * D + 1; }
+
+    static std::string MakeName() {
+        if (D == 2)
+            return "binary (flat implicit) heap";
+        return std::to_string(D) + "-ary (flat implicit) heap";
+    }
+
+    void Place(std::size_t index, Key key, Handle slot) {
+        keys[index] = key;
+        handles[index] = slot;
+        slots[slot].index = index;
+    }
+
+    void Move(std::size_t to, std::size_t from) {
+        Place(to, keys[from], handles[from]);
+    }
+
+    std::size_t HeapifyUp(std::size_t index) {
+        Key key = keys[index];
+        Handle slot = handles[index];
+
+        while (index > 0 && compare(key, keys[ParentIndex(index)])) {
+            Move(index, ParentIndex(index));
+            index = ParentIndex(index);
+        }
+
+        Place(index, key, slot);
+        return index;
+    }
+
+    // index of the smallest key among keys[first, last)
+    std::size_t SmallestChild(std::size_t first, std::size_t last) const {
+        if (last - first == D)
+            return first + MinChild< D, Key, Compare >::Find(&keys[first], compare);
+
+        std::size_t smallest = first;
+        for (std::size_t i = first + 1; i < last; ++i) {
+            if (compare(keys[i], keys[smallest]))
+                smallest = i;
+        }
+        return smallest;
+    }
+
+    void HeapifyDown(std::size_t index) {
+        Key key = keys[index];
+        Handle slot = handles[index];
+        std::size_t size = keys.size();
+
+        for (std::size_t first; (first = FirstChildIndex(index)) < size;) {
+            std::size_t last = first + D < size ? first + D : size;
+            std::size_t smallest = SmallestChild(first, last);
+
+            if (!compare(keys[smallest], key))
+                break;
+
+            Move(index, smallest);
+            index = smallest;
+        }
+
+        Place(index, key, slot);
+    }
+
+    // unlinks the minimum and frees its slot, whose node is still readable
+    Handle RemoveMin() {
+        if (keys.empty())
+            EmptyException();
+
+        Handle h = handles.front();
+        Move(0, keys.size() - 1);
+        keys.pop_back();
+        handles.pop_back();
+
+        if (!keys.empty())
+            HeapifyDown(0);
+
+        freed.push_back(h);
+        return h;
+    }
+
+    template < typename... Args >
+    Handle NewSlot(Key key, Args&&... args) {
+        if (freed.empty()) {
+            freed.push_back(slots.size());
+            slots.emplace_back();
+        }
+
+        Handle h = freed.back();
+        slots[h].node.emplace(key, std::forward< Args >(args)...);
+        freed.pop_back();
+        slots[h].index = keys.size();
+        return h;
+    }
+
+public:
+    using NodeType = Node;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
+
+    DaryHeap() : HeapBase(MakeName()) {
+        keys.reserve(4096);
+        handles.reserve(4096);
+        slots.reserve(4096);
+    }
+
+    bool Empty() const {
+        return keys.empty();
+    }
+
+    const Node& Min() const {
+        if (keys.empty())
+            EmptyException();
+        return *slots[handles.front()].node;
+    }
+
+    // handle stays valid until its node is extracted
+    const Node& Get(Handle handle) const {
+        return *slots[handle].node;
+    }
+
+    Handle Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    Handle Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    Handle Emplace(Key key, Args&&... args) {
+        Handle h = NewSlot(key, std::forward< Args >(args)...);
+        keys.push_back(key);
+        handles.push_back(h);
+        HeapifyUp(keys.size() - 1);
+        return h;
+    }
+
+    void DecreaseKey(Handle handle, Key key) {
+        auto& slot = slots[handle];
+        if (compare(slot.node->key, key))
+            InvalidKeyException();
+
+        slot.node->key = key;
+        keys[slot.index] = key;
+        HeapifyUp(slot.index);
+    }
+
+    Node ExtractMin() {
+        return std::move(*slots[RemoveMin()].node);
+    }
+
+    std::pair< Key, Item > Pop() {
+        auto& min = *slots[RemoveMin()].node;
+        return { min.key, std::move(min.item) };
+    }
+
+    const std::vector< Key >& Keys() const { return keys; }
+};
+
+template < typename Item >
+using FlatImplicitHeap = DaryHeap< Item, 2 >;
+
+template < typename Item >
+using Dary4Heap = DaryHeap< Item, 4 >;
+
+template < typename Item >
+using Dary8Heap = DaryHeap< Item, 8 >;
+
+template < typename Item >
+using Dary16Heap = DaryHeap< Item, 16 >;
+
+}
@@ -0,0 +1,258 @@
+#define CATCH_CONFIG_MAIN
+
+#include "../../catch/catch.hpp"
+#include "dary_heap.hpp"
+#include <algorithm>
+#include <memory>
+#include <random>
+
+using heap = MC::FlatImplicitHeap< int >;
+using vector = std::vector< int >;
+
+template < typename H >
+vector Keys(const H& h) {
+    return h.Keys();
+}
+
+heap Generate(int size, bool reversed) {
+    heap h;
+    for (int i = 0; i < size; ++i) {
+        int v = reversed ? size - 1 - i : i;
+        h.Insert(v, v);
+    }
+    return h;
+}
+
+TEST_CASE("empty") {
+    heap h;
+
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.Min());
+    REQUIRE_THROWS(h.ExtractMin());
+}
+
+TEST_CASE("insert") {
+    SECTION("normal") {
+        auto h = Generate(10, false);
+        vector expected = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        CHECK(Keys(h) == expected);
+    }
+
+    SECTION("reversed") {
+        auto h = Generate(10, true);
+        vector expected = {0, 1, 4, 3, 2, 8, 5, 9, 6, 7};
+        CHECK(Keys(h) == expected);
+    }
+}
+
+TEST_CASE("extract") {
+    SECTION("normal") {
+        auto h = Generate(5, false);
+        auto min = h.ExtractMin();
+        CHECK(min.key == 0);
+        CHECK(min.item == 0);
+        vector expected = {1, 3, 2, 4};
+        CHECK(Keys(h) == expected);
+    }
+
+    SECTION("reversed") {
+        auto h = Generate(5, true);
+        auto min = h.ExtractMin();
+        CHECK(min.key == 0);
+        vector expected = {1, 2, 3, 4};
+        CHECK(Keys(h) == expected);
+    }
+}
+
+TEST_CASE("pop") {
+    MC::Dary4Heap< std::string > h;
+    for (int i = 9; i >= 0; --i)
+        h.Insert(i, std::to_string(i));
+
+    for (int i = 0; i < 10; ++i) {
+        auto p = h.Pop();
+        CHECK(p.first == i);
+        CHECK(p.second == std::to_string(i));
+    }
+    REQUIRE_THROWS(h.Pop());
+}
+
+TEST_CASE("emplace") {
+    SECTION("constructor arguments") {
+        MC::Dary4Heap< std::string > h;
+        for (int i = 5; i > 0; --i)
+            h.Emplace(i, std::size_t(i), 'x');
+
+        auto p = h.Pop();
+        CHECK(p.first == 1);
+        CHECK(p.second == "x");
+        CHECK(h.Min().item == "xx");
+    }
+
+    SECTION("move-only items") {
+        MC::FlatImplicitHeap< std::unique_ptr< int > > h;
+        for (int i = 0; i < 10; ++i)
+            h.Insert(10 - i, std::make_unique< int >(i));
+        auto first = h.Emplace(0, new int(-1));
+
+        CHECK(*h.Get(first).item == -1);
+        CHECK(*h.Pop().second == -1);
+        CHECK(*h.Pop().second == 9);
+
+        // recycled slots are rebuilt in place
+        h.Emplace(0, new int(42));
+        CHECK(*h.Pop().second == 42);
+    }
+}
+
+TEST_CASE("handles") {
+    heap h;
+    std::vector< heap::Handle > inserted;
+
+    for (int i = 0; i < 10; ++i)
+        inserted.push_back(h.Insert(i, i));
+
+    SECTION("decrease key") {
+        h.DecreaseKey(inserted.back(), -1);
+
+        REQUIRE(h.Min().key == -1);
+        REQUIRE(h.Min().item == 9);
+        REQUIRE_THROWS_AS(h.DecreaseKey(inserted.back(), 5), const std::logic_error&);
+    }
+
+    SECTION("stable across extracts") {
+        h.ExtractMin();
+        h.ExtractMin();
+
+        for (int i = 2; i < 10; ++i) {
+            CHECK(h.Get(inserted[i]).key == i);
+            CHECK(h.Get(inserted[i]).item == i);
+        }
+
+        h.DecreaseKey(inserted[7], 0);
+        REQUIRE(h.ExtractMin().item == 7);
+    }
+
+    SECTION("recycled") {
+        h.ExtractMin();
+        auto n = h.Insert(-5, 42);
+
+        CHECK(n == inserted.front());
+        CHECK(h.Min().item == 42);
+    }
+}
+
+template < unsigned D >
+void RandomOperations() {
+    MC::DaryHeap< int, D > h;
+    std::mt19937 rng(D);
+    std::uniform_int_distribution< int > uid(-1000, 1000);
+
+    std::vector< std::size_t > inserted;
+    for (int i = 0; i < 1000; ++i)
+        inserted.push_back(h.Insert(uid(rng), i));
+
+    for (auto n : inserted) {
+        int k = h.Get(n).key;
+        h.DecreaseKey(n, k - std::abs(uid(rng)));
+    }
+
+    int last = h.Min().key;
+    for (int i = 0; i < 1000; ++i) {
+        auto min = h.ExtractMin();
+        REQUIRE(last <= min.key);
+        last = min.key;
+    }
+    REQUIRE(h.Empty());
+}
+
+TEST_CASE("min child") {
+    std::mt19937 rng(3);
+    std::uniform_int_distribution< int > uid(-4, 4);
+
+    for (int run = 0; run < 1000; ++run) {
+        vector keys(16);
+        std::generate(keys.begin(), keys.end(), [&]() { return uid(rng); });
+
+        auto first = [&keys](std::size_t count) {
+            return std::size_t(std::min_element(keys.begin(), keys.begin() + count) - keys.begin());
+        };
+
+        auto min4 = MC::MinChild< 4, int, std::less< int > >::Find(keys.data(), std::less< int >());
+        REQUIRE(min4 == first(4));
+        auto min8 = MC::MinChild< 8, int, std::less< int > >::Find(keys.data(), std::less< int >());
+        REQUIRE(min8 == first(8));
+        auto min16 = MC::MinChild< 16, int, std::less< int > >::Find(keys.data(), std::less< int >());
+        REQUIRE(min16 == first(16));
+    }
+}
+
+TEST_CASE("generic keys") {
+    SECTION("greater") {
+        MC::DaryHeap< int, 4, int, std::greater< int > > h;
+        for (int i = 0; i < 20; ++i)
+            h.Insert(i, i);
+
+        auto n = h.Insert(-1, -1);
+        h.DecreaseKey(n, 100);
+        REQUIRE_THROWS(h.DecreaseKey(n, 0));
+
+        CHECK(h.Pop().second == -1);
+        for (int i = 19; i >= 0; --i)
+            CHECK(h.Pop().first == i);
+    }
+
+    SECTION("double") {
+        MC::DaryHeap< int, 8, double > h;
+        for (int k = 0; k < 20; ++k)
+            h.Insert(k / 4.0, k);
+
+        CHECK(h.Pop().first == 0.0);
+        CHECK(h.Pop().first == 0.25);
+        CHECK(decltype(h)::Infinity == std::numeric_limits< double >::infinity());
+    }
+
+    SECTION("pair") {
+        using key = std::pair< int, int >;
+        MC::DaryHeap< int, 2, key > h;
+        h.Insert({1, 2}, 0);
+        h.Insert({1, 1}, 1);
+        h.Insert({0, 9}, 2);
+
+        CHECK(h.Pop().second == 2);
+        CHECK(h.Pop().second == 1);
+        CHECK(decltype(h)::Infinity.first == std::numeric_limits< int >::max());
+    }
+}
+
+TEST_CASE("arity") {
+    SECTION("4-ary reversed insert") {
+        MC::Dary4Heap< int > h;
+        for (int i = 9; i >= 0; --i)
+            h.Insert(i, i);
+
+        vector expected = {0, 2, 1, 7, 6, 9, 5, 4, 3, 8};
+        CHECK(Keys(h) == expected);
+    }
+
+    SECTION("4-ary extract") {
+        MC::Dary4Heap< int > h;
+        for (int i = 0; i < 6; ++i)
+            h.Insert(i, i);
+
+        CHECK(h.ExtractMin().key == 0);
+        vector expected = {1, 5, 2, 3, 4};
+        CHECK(Keys(h) == expected);
+    }
+
+    SECTION("names") {
+        CHECK(MC::FlatImplicitHeap< int >().Name == "binary (flat implicit) heap");
+        CHECK(MC::Dary8Heap< int >().Name == "8-ary (flat implicit) heap");
+    }
+
+    SECTION("random - 2") { RandomOperations< 2 >(); }
+    SECTION("random - 4") { RandomOperations< 4 >(); }
+    SECTION("random - 8") { RandomOperations< 8 >(); }
+    SECTION("random - 16") { RandomOperations< 16 >(); }
+    SECTION("random - 3") { RandomOperations< 3 >(); }
+}
@@ -4,22 +4,25 @@
 #include <memory>
 #include <functional>
 #include <vector>
+#include <utility>
 
 
 namespace MC {
 
-template < typename Item >
+template < typename Item, typename Key = int, typename Compare = std::less< Key > >
 class ImplicitHeap : public HeapBase {
     struct Node {
-        int key;
+        Key key;
         Item item;
         int index;
 
-        Node(int k, const Item& i, int index)
-                : key(k), item(i), index(index) {}
+        template < typename... Args >
+        Node(int index, Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...), index(index) {}
     };
 
     std::vector< std::unique_ptr< Node > > array;
+    Compare compare;
 
 
     int ParentIndex(int index) const { return (index - 1) / 2 ; }
@@ -51,11 +54,11 @@ class ImplicitHeap : public HeapBase {
 
         std::size_t smallest = index;
 
-        if (InBounds(LeftIndex(index)) && Left(index)->key < array[index]->key) {
+        if (InBounds(LeftIndex(index)) && compare(Left(index)->key, array[index]->key)) {
             smallest = LeftIndex(index);
         }
 
-        if (InBounds(RightIndex(index)) && Right(index)->key < array[smallest]->key) {
+        if (InBounds(RightIndex(index)) && compare(Right(index)->key, array[smallest]->key)) {
             smallest = RightIndex(index);
         }
 
@@ -70,6 +73,9 @@ class ImplicitHeap : public HeapBase {
 
 public:
     using NodeType = typename ImplicitHeap::Node;
+    using Handle = const NodeType*;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
     ImplicitHeap() : HeapBase("binary (implicit) heap") {
         array.reserve(4096);
     }
@@ -80,13 +86,22 @@ public:
         return *array[0];
     }
 
-    void DecreaseKey(const Node* node, int key) {
+    void DecreaseKey(const Node* node, Key key) {
         DecreaseKey(node->index, key);
     }
 
-    const Node* Insert(int key, const Item& item) {
-        array.emplace_back(std::make_unique< Node >(Infinity, item, array.size()));
-        return array[DecreaseKey(array.size() - 1, key)].get();
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        array.emplace_back(std::make_unique< Node >(array.size(), key, std::forward< Args >(args)...));
+        return array[HeapifyUp(array.size() - 1)].get();
     }
 
     bool Empty() const {
@@ -105,16 +120,24 @@ public:
         return ret;
     }
 
+    std::pair< Key, Item > Pop() {
+        auto min = ExtractMin();
+        return { min->key, std::move(min->item) };
+    }
+
     const std::vector< std::unique_ptr< Node > >& Elements() const { return array; }
 
 private:
-    int DecreaseKey(int index, int key) {
-        if (key > array[index]->key)
+    int DecreaseKey(int index, Key key) {
+        if (compare(array[index]->key, key))
             InvalidKeyException();
 
         array[index]->key = key;
+        return HeapifyUp(index);
+    }
 
-        while (index > 0 && array[index]->key < Parent(index)->key) {
+    int HeapifyUp(int index) {
+        while (index > 0 && compare(array[index]->key, Parent(index)->key)) {
             std::swap(array[index], Parent(index));
             std::swap(array[index]->index, Parent(index)->index);
             index = ParentIndex(index);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+namespace MC {
+
+// Finds the position of the smallest of D contiguous keys, the first one on
+// ties. The generic version is a plain scan; for int keys ordered by
+// std::less the SSE4.1 and AVX2 versions are chosen at compile time (e.g.
+// -msse4.1, -mavx2 or -march=native) and reduce whole registers of siblings
+// at once.
+template < unsigned D, typename Key, typename Compare, typename = void >
+struct MinChild {
+    static std::size_t Find(const Key* keys, const Compare& compare) {
+        std::size_t smallest = 0;
+        for (std::size_t i = 1; i < D; ++i) {
+            if (compare(keys[i], keys[smallest]))
+                smallest = i;
+        }
+        return smallest;
+    }
+};
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+
+inline unsigned LowestSetBit(unsigned mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+#endif
+
+#if defined(__AVX2__)
+
+template < unsigned D >
+struct MinChild< D, int, std::less< int >, typename std::enable_if< D % 8 == 0 >::type > {
+    static __m256i Load(const int* keys) {
+        return _mm256_loadu_si256(reinterpret_cast< const __m256i* >(keys));
+    }
+
+    static std::size_t Find(const int* keys, const std::less< int >&) {
+        __m256i min = Load(keys);
+        for (unsigned i = 8; i < D; i += 8)
+            min = _mm256_min_epi32(min, Load(keys + i));
+
+        // broadcast the minimum into every lane
+        min = _mm256_min_epi32(min, _mm256_permute2x128_si256(min, min, 1));
+        min = _mm256_min_epi32(min, _mm256_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+        min = _mm256_min_epi32(min, _mm256_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        for (unsigned i = 0;; i += 8) {
+            __m256i eq = _mm256_cmpeq_epi32(Load(keys + i), min);
+            unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+            if (mask)
+                return i + LowestSetBit(mask);
+        }
+    }
+};
+
+#endif
+
+#if defined(__SSE4_1__)
+
+template < unsigned D >
+struct MinChild< D, int, std::less< int >, typename std::enable_if< D % 4 == 0
+#if defined(__AVX2__)
+                                                                     && D % 8 != 0
+#endif
+                                                                     >::type > {
+    static __m128i Load(const int* keys) {
+        return _mm_loadu_si128(reinterpret_cast< const __m128i* >(keys));
+    }
+
+    static std::size_t Find(const int* keys, const std::less< int >&) {
+        __m128i min = Load(keys);
+        for (unsigned i = 4; i < D; i += 4)
+            min = _mm_min_epi32(min, Load(keys + i));
+
+        // broadcast the minimum into every lane
+        min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(1, 0, 3, 2)));
+        min = _mm_min_epi32(min, _mm_shuffle_epi32(min, _MM_SHUFFLE(2, 3, 0, 1)));
+
+        for (unsigned i = 0;; i += 4) {
+            __m128i eq = _mm_cmpeq_epi32(Load(keys + i), min);
+            unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(eq));
+            if (mask)
+                return i + LowestSetBit(mask);
+        }
+    }
+};
+
+#endif
+
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
+
+namespace MC {
+
+// Combining strategies of PairingHeap, applied to the children of an extracted
+// root; first is the leftmost of a list linked through next.
+// Two-pass links pairs left to right, then folds the pairs right to left.
+struct TwoPass {
+    constexpr static const char* Name = "pairing heap (two-pass)";
+
+    template < typename Node, typename Link >
+    static Node* Combine(Node* first, Link link) {
+        // first pass, the pairs are stacked through next
+        Node* pairs = nullptr;
+        while (first) {
+            Node* a = first;
+            Node* b = a->next;
+            first = b ? b->next : nullptr;
+
+            Node* w = b ? link(a, b) : a;
+            w->next = pairs;
+            pairs = w;
+        }
+
+        // second pass, the top of the stack is the rightmost pair
+        Node* root = pairs;
+        pairs = pairs->next;
+        while (pairs) {
+            Node* next = pairs->next;
+            root = link(root, pairs);
+            pairs = next;
+        }
+        return root;
+    }
+};
+
+// Multipass keeps the subtrees in a queue, linking the two at its front and
+// appending the result, until one tree is left.
+struct Multipass {
+    constexpr static const char* Name = "pairing heap (multipass)";
+
+    template < typename Node, typename Link >
+    static Node* Combine(Node* first, Link link) {
+        Node* tail = first;
+        while (tail->next)
+            tail = tail->next;
+
+        Node* head = first;
+        while (head != tail) {
+            Node* a = head;
+            Node* b = a->next;
+            head = b->next;
+
+            Node* w = link(a, b);
+            if (!head)
+                return w;
+            tail->next = w;
+            tail = w;
+        }
+        return head;
+    }
+};
+
+template < typename Item, typename Key = int, typename Compare = std::less< Key >, typename Pass = TwoPass >
+class PairingHeap : public HeapBase {
+    struct Node {
+        Key key;
+        Item item;
+
+        Node* child = nullptr;
+        Node* next = nullptr;
+        // previous sibling, or the parent of a leftmost child
+        Node* prev = nullptr;
+
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
+    };
+
+    Node* root = nullptr;
+    NodePool< Node > pool;
+    Compare compare;
+
+    // makes the root with the larger key the leftmost child of the other one
+    Node* Link(Node* x, Node* y) {
+        if (compare(y->key, x->key))
+            std::swap(x, y);
+
+        x->next = x->prev = nullptr;
+        y->prev = x;
+        y->next = x->child;
+        if (x->child)
+            x->child->prev = y;
+        x->child = y;
+        return x;
+    }
+
+    // detaches n with its subtree from its parent and siblings
+    static void Cut(Node* n) {
+        if (n->prev->child == n)
+            n->prev->child = n->next;
+        else
+            n->prev->next = n->next;
+
+        if (n->next)
+            n->next->prev = n->prev;
+        n->next = n->prev = nullptr;
+    }
+
+    // destroys the tree under n, rotating children onto the sibling list
+    // instead of recursing, as trees may degenerate into long paths
+    void Free(Node* n) {
+        while (n) {
+            if (n->child) {
+                Node* c = n->child;
+                n->child = c->next;
+                c->next = n;
+                n = c;
+            } else {
+                Node* next = n->next;
+                pool.Delete(n);
+                n = next;
+            }
+        }
+    }
+
+public:
+    using NodeType = Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
+
+    PairingHeap() : HeapBase(Pass::Name) {}
+
+    ~PairingHeap() {
+        if (!NodePool< Node >::TriviallyDestructible)
+            Free(root);
+    }
+
+    bool Empty() const {
+        return root == nullptr;
+    }
+
+    const Node& Min() const {
+        if (!root)
+            EmptyException();
+        return *root;
+    }
+
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        auto n = pool.New(key, std::forward< Args >(args)...);
+        root = root ? Link(root, n) : n;
+        return n;
+    }
+
+    void DecreaseKey(const Node* node, Key key) {
+        if (compare(node->key, key))
+            InvalidKeyException();
+
+        auto n = const_cast< Node* >(node);
+        n->key = key;
+        if (n == root)
+            return;
+
+        Cut(n);
+        root = Link(root, n);
+    }
+
+    NodePtr ExtractMin() {
+        if (!root)
+            EmptyException();
+
+        NodePtr ret = pool.Own(root);
+        Node* first = root->child;
+        root->child = nullptr;
+
+        if (first) {
+            first->prev = nullptr;
+            root = Pass::Combine(first, [this](Node* x, Node* y) { return Link(x, y); });
+            root->next = root->prev = nullptr;
+        } else {
+            root = nullptr;
+        }
+        return ret;
+    }
+
+    std::pair< Key, Item > Pop() {
+        auto min = ExtractMin();
+        return { min->key, std::move(min->item) };
+    }
+};
+
+template < typename Item >
+using MultipassPairingHeap = PairingHeap< Item, int, std::less< int >, Multipass >;
+
+}
@@ -0,0 +1,85 @@
+#define CATCH_CONFIG_MAIN
+
+#include "../../catch/catch.hpp"
+#include "pairing_heap.hpp"
+#include "../helpers/random_operations.hpp"
+#include <vector>
+
+using two_pass = MC::PairingHeap< int >;
+using multipass = MC::MultipassPairingHeap< int >;
+
+TEST_CASE("Insert") {
+    two_pass h;
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.Min());
+
+    auto n = h.Insert(1, 1);
+    CHECK(&h.Min() == n);
+    CHECK(n->child == nullptr);
+
+    auto m = h.Insert(0, 0);
+    CHECK(&h.Min() == m);
+    CHECK(m->child == n);
+    CHECK(n->prev == m);
+
+    h.Insert(2, 2);
+    CHECK(h.Min().key == 0);
+    CHECK(m->child->key == 2);
+}
+
+TEST_CASE("ExtractMin") {
+    two_pass h;
+    for (int i = 9; i >= 0; --i)
+        h.Insert(i, i);
+
+    for (int i = 0; i < 10; ++i) {
+        auto n = h.ExtractMin();
+        CHECK(n->key == i);
+        CHECK(n->child == nullptr);
+    }
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.ExtractMin());
+}
+
+TEST_CASE("DecreaseKey") {
+    two_pass h;
+    std::vector< two_pass::Handle > handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(h.Insert(10 + i, i));
+
+    SECTION("root") {
+        h.DecreaseKey(handles[0], 0);
+        CHECK(h.Min().item == 0);
+        CHECK(h.Min().key == 0);
+    }
+
+    SECTION("leftmost child") {
+        h.DecreaseKey(handles[9], 5);
+        CHECK(h.Min().item == 9);
+        CHECK(h.Pop().first == 5);
+        CHECK(h.Pop().first == 10);
+    }
+
+    SECTION("inner node") {
+        h.Pop();
+        h.DecreaseKey(handles[5], 1);
+        h.DecreaseKey(handles[7], 2);
+        REQUIRE_THROWS(h.DecreaseKey(handles[8], 30));
+
+        std::vector< int > expected = { 1, 2, 11, 12, 13, 14, 16, 18, 19 };
+        for (int k : expected)
+            CHECK(h.Pop().first == k);
+        CHECK(h.Empty());
+    }
+}
+
+TEST_CASE("Names") {
+    CHECK(two_pass().Name == "pairing heap (two-pass)");
+    CHECK(multipass().Name == "pairing heap (multipass)");
+}
+
+TEST_CASE("Random") {
+    helpers::UniformKeys keys{ 1000, 100 };
+    SECTION("two-pass") { helpers::RandomOperations< two_pass >(42, 5000, keys); }
+    SECTION("multipass") { helpers::RandomOperations< multipass >(42, 5000, keys); }
+}
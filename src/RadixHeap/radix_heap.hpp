@@ -0,0 +1,172 @@
+#pragma once
+
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
+
+namespace MC {
+
+// Radix heap for monotone integer keys: no key may be smaller than the last
+// extracted minimum, which holds for Dijkstra with non-negative weights.
+// Bucket b > 0 keeps the nodes whose key first differs from that minimum in
+// bit b - 1, bucket 0 the nodes equal to it. Extracting from an empty bucket
+// 0 redistributes the first non-empty bucket, each node moving down at most
+// once per bit.
+template < typename Item, typename Key = int >
+class RadixHeap : public HeapBase {
+    static_assert(std::is_integral< Key >::value, "radix heap needs integer keys");
+
+    using Bits = typename std::make_unsigned< Key >::type;
+
+    constexpr static unsigned BucketCount = std::numeric_limits< Bits >::digits + 1;
+
+    struct Node {
+        Key key;
+        Item item;
+
+        unsigned bucket = 0;
+        std::size_t index = 0;
+
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
+    };
+
+    std::vector< Node* > buckets[BucketCount];
+    // holds a bucket while it is redistributed, so no capacity is lost
+    std::vector< Node* > scratch;
+    // smallest key still allowed, the last extracted one
+    Key last = std::numeric_limits< Key >::min();
+    Node* min = nullptr;
+    std::size_t count = 0;
+    NodePool< Node > pool;
+
+    unsigned BucketIndex(Key key) const {
+        Bits diff = ToBits(key) ^ ToBits(last);
+        return diff ? FloorLog2(diff) + 1 : 0;
+    }
+
+    void Push(Node* n) {
+        auto& bucket = buckets[n->bucket = BucketIndex(n->key)];
+        n->index = bucket.size();
+        bucket.push_back(n);
+    }
+
+    void Erase(Node* n) {
+        auto& bucket = buckets[n->bucket];
+        Node* moved = bucket.back();
+        bucket[n->index] = moved;
+        moved->index = n->index;
+        bucket.pop_back();
+    }
+
+    // smallest node of the first non-empty bucket, nullptr if there is none
+    Node* FindMin() const {
+        for (auto& bucket : buckets) {
+            if (bucket.empty())
+                continue;
+
+            Node* m = bucket.front();
+            for (Node* n : bucket) {
+                if (n->key < m->key)
+                    m = n;
+            }
+            return m;
+        }
+        return nullptr;
+    }
+
+public:
+    using NodeType = Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
+
+    RadixHeap() : HeapBase("radix heap") {}
+
+    ~RadixHeap() {
+        if (NodePool< Node >::TriviallyDestructible)
+            return;
+        for (auto& bucket : buckets) {
+            for (Node* n : bucket)
+                pool.Delete(n);
+        }
+    }
+
+    bool Empty() const {
+        return count == 0;
+    }
+
+    const Node& Min() const {
+        if (!min)
+            EmptyException();
+        return *min;
+    }
+
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        CheckMonotone(key, last);
+
+        auto n = pool.New(key, std::forward< Args >(args)...);
+        Push(n);
+        ++count;
+        if (!min || key < min->key)
+            min = n;
+        return n;
+    }
+
+    void DecreaseKey(const Node* node, Key key) {
+        if (node->key < key)
+            InvalidKeyException();
+        CheckMonotone(key, last);
+
+        auto n = const_cast< Node* >(node);
+        n->key = key;
+        if (BucketIndex(key) != n->bucket) {
+            Erase(n);
+            Push(n);
+        }
+
+        if (key < min->key)
+            min = n;
+    }
+
+    NodePtr ExtractMin() {
+        if (!min)
+            EmptyException();
+
+        Node* n = min;
+        if (n->bucket != 0) {
+            // every node of its bucket moves to a lower one
+            last = n->key;
+            scratch.swap(buckets[n->bucket]);
+            for (Node* x : scratch)
+                Push(x);
+            scratch.clear();
+        }
+
+        Erase(n);
+        --count;
+        min = buckets[0].empty() ? FindMin() : buckets[0].back();
+        return pool.Own(n);
+    }
+
+    std::pair< Key, Item > Pop() {
+        auto top = ExtractMin();
+        return { top->key, std::move(top->item) };
+    }
+};
+
+}
@@ -0,0 +1,96 @@
+#define CATCH_CONFIG_MAIN
+
+#include "../../catch/catch.hpp"
+#include "radix_heap.hpp"
+#include "../helpers/random_operations.hpp"
+#include <cstdint>
+#include <vector>
+
+using radix = MC::RadixHeap< int >;
+
+TEST_CASE("Insert") {
+    radix h;
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.Min());
+
+    h.Insert(5, 5);
+    auto n = h.Insert(3, 3);
+    h.Insert(8, 8);
+    CHECK(&h.Min() == n);
+    CHECK(h.Min().item == 3);
+}
+
+TEST_CASE("ExtractMin") {
+    radix h;
+    std::vector< int > keys = { 7, 0, 7, 1024, 3, 2, 2, 65535, 1 };
+    for (int k : keys)
+        h.Insert(k, k);
+
+    std::vector< int > expected = { 0, 1, 2, 2, 3, 7, 7, 1024, 65535 };
+    for (int k : expected) {
+        auto n = h.ExtractMin();
+        CHECK(n->key == k);
+    }
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.ExtractMin());
+}
+
+TEST_CASE("DecreaseKey") {
+    radix h;
+    std::vector< radix::Handle > handles;
+    for (int i = 0; i < 10; ++i)
+        handles.push_back(h.Insert(radix::Infinity, i));
+
+    h.DecreaseKey(handles[4], 0);
+    CHECK(h.Min().item == 4);
+    CHECK(h.Pop().first == 0);
+
+    h.DecreaseKey(handles[7], 2);
+    h.DecreaseKey(handles[2], 1);
+    h.DecreaseKey(handles[7], 1);
+    REQUIRE_THROWS(h.DecreaseKey(handles[2], 3));
+
+    CHECK(h.Pop().first == 1);
+    CHECK(h.Pop().first == 1);
+    CHECK(h.Min().key == radix::Infinity);
+}
+
+TEST_CASE("Monotonicity") {
+#ifndef NDEBUG
+    radix h;
+    auto n = h.Insert(10, 0);
+    h.Insert(20, 1);
+    h.Pop();
+
+    REQUIRE_THROWS(h.Insert(5, 2));
+    h.Insert(10, 3);
+    REQUIRE_THROWS(h.DecreaseKey(n, 9) );
+#endif
+}
+
+TEST_CASE("Key types") {
+    SECTION("negative") {
+        radix h;
+        h.Insert(3, 0);
+        h.Insert(-7, 1);
+        h.Insert(-1, 2);
+        CHECK(h.Pop().first == -7);
+        CHECK(h.Pop().first == -1);
+        CHECK(h.Pop().first == 3);
+    }
+
+    SECTION("uint64_t") {
+        MC::RadixHeap< int, std::uint64_t > h;
+        std::uint64_t big = std::uint64_t(1) << 63;
+        h.Insert(big, 0);
+        h.Insert(big - 1, 1);
+        h.Insert(1, 2);
+        CHECK(h.Pop().second == 2);
+        CHECK(h.Pop().second == 1);
+        CHECK(h.Pop().second == 0);
+    }
+}
+
+TEST_CASE("Random monotone") {
+    helpers::RandomOperations< radix >(7, 20000, helpers::MonotoneKeys(5000));
+}
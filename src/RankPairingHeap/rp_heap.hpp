@@ -1,18 +1,40 @@
 #pragma once
 
 #include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
 #include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace MC {
 
-template < typename >
-class RankPairingHeap2;
+// Rank reduction rules of RankPairingHeap, giving the new rank of a node from
+// the ranks of its left child and its right spine successor (-1 if missing).
+// Type 1 takes the larger rank, plus one if they are equal.
+struct Type1Reduction {
+    constexpr static const char* Name = "rank-pairing heap t1";
 
-template < typename Item >
+    static int Rank(int x, int y) {
+        return std::max(x, y) + (x == y);
+    }
+};
+
+// Type 2 takes the larger rank, plus one if they differ by at most one.
+struct Type2Reduction {
+    constexpr static const char* Name = "rank-pairing heap t2";
+
+    static int Rank(int x, int y) {
+        return std::max(x, y) + (std::abs(x - y) <= 1);
+    }
+};
+
+template < typename Item, typename Key = int, typename Compare = std::less< Key >, typename Reduction = Type1Reduction >
 class RankPairingHeap : public HeapBase {
 protected:
     struct Node {
-        int key;
+        Key key;
         Item item;
 
         Node* left = nullptr;
@@ -21,8 +43,9 @@ protected:
 
         int rank = 0;
 
-        Node(int k, const Item& i)
-            : key(k), item(i) {}
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
 
         Node* Reset() {
             left = nullptr;
@@ -48,29 +71,24 @@ protected:
             rank = left ? left->rank + 1 : 0;
         }
 
-        ~Node() {
-            if (left) {
-                delete left;
-            }
-
-            if (!IsRoot() && next) {
-                delete next;
-            }
-        }
-
     };
 
     Node* root = nullptr;
     std::size_t size = 0;
-
-    RankPairingHeap(const std::string& n) : HeapBase(n) {}
-
-    template < typename > friend class RankPairingHeap2;
+    // half-trees by rank during ExtractMin, all null in between; grows only
+    std::vector< Node* > buckets;
+    std::size_t maxRank = 0;
+    NodePool< Node > pool;
+    Compare compare;
 
 public:
     using NodeType = RankPairingHeap::Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
 
-    RankPairingHeap() : HeapBase("rank-pairing heap t1") {}
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
+
+    RankPairingHeap() : HeapBase(Reduction::Name) {}
 
     bool Empty() const {
         return size == 0;
@@ -82,24 +100,35 @@ public:
         return *root;
     }
 
-    const Node* Insert(int key,const Item& item) {
-        auto n = new Node(key, item);
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        auto n = pool.New(key, std::forward< Args >(args)...);
         AddToRootList(n);
         ++size;
 
         return n;
     }
 
-    std::unique_ptr< Node > ExtractMin() {
+    NodePtr ExtractMin() {
         if (!root)
             EmptyException();
 
-        std::vector< Node* > buckets(MaxBuckets(), nullptr);
+        if (buckets.size() < MaxBuckets())
+            buckets.resize(MaxBuckets(), nullptr);
+        maxRank = 0;
 
         // traverse children
         for (auto n = root->left; n != nullptr;) {
             auto next = n->ResetNextAndParent();
-            MergeIntoBuckets(buckets, n);
+            MergeIntoBuckets(n);
             n = next;
         }
 
@@ -108,28 +137,34 @@ public:
         // traverse roots
         for (auto n = root->next; n != root;) {
             auto next = n->ResetNext();
-            MergeIntoBuckets(buckets, n);
+            MergeIntoBuckets(n);
             n = next;
         }
 
-        std::unique_ptr< Node > ret(root);
+        NodePtr ret = pool.Own(root);
         root = nullptr;
-        std::for_each(buckets.begin(), buckets.end(), [this](auto n) {
-            AddToRootList(n);
-        });
+        for (std::size_t r = 0; r <= maxRank; ++r) {
+            AddToRootList(buckets[r]);
+            buckets[r] = nullptr;
+        }
         --size;
         return ret;
     }
 
-    void DecreaseKey(const Node* node, int key) {
-        if (key > node->key)
+    std::pair< Key, Item > Pop() {
+        auto min = ExtractMin();
+        return { min->key, std::move(min->item) };
+    }
+
+    void DecreaseKey(const Node* node, Key key) {
+        if (compare(node->key, key))
             InvalidKeyException();
 
         auto n = const_cast< Node* >(node);
         n->key = key;
 
         if (n->IsRoot()) {
-            if (n->key < root->key)
+            if (compare(n->key, root->key))
                 root = n;
             return;
         }
@@ -159,7 +194,8 @@ public:
     }
 
     ~RankPairingHeap() {
-        FreeRoots();
+        if (!NodePool< Node >::TriviallyDestructible)
+            FreeRoots();
     }
 
 private:
@@ -171,26 +207,31 @@ private:
         auto n = root;
         do {
             auto p = n->next;
-            delete n;
+            Free(n);
             n = p;
         } while (n != root);
 
         root = nullptr;
     }
 
+    // destroys n with its half-tree; a root's next is the root list
+    void Free(Node* n) {
+        if (n->left)
+            Free(n->left);
+
+        if (!n->IsRoot() && n->next)
+            Free(n->next);
+
+        pool.Delete(n);
+    }
+
 
     void ReduceRanks(Node* n) {
         while (!n->IsRoot()) {
             int x = n->left ? n->left->rank : -1;
             int y = n->next ? n->next->rank : -1;
 
-#ifndef PAIRING2
-            // type-1 rank reduction
-            int z = x != y ? std::max(x, y) : x + 1;
-#else
-            // type-2 rank reduction
-            int z = (std::abs(x- y) > 1) ? std::max(x, y) : std::max(x, y) + 1;
-#endif
+            int z = Reduction::Rank(x, y);
             if (z >= n->rank)
                 break;
 
@@ -212,20 +253,22 @@ private:
         } else {
             n->next = root->next;
             root->next = n;
-            if (n->key < root->key)
+            if (compare(n->key, root->key))
                 root = n;
         }
     }
 
+    // ranks stay logarithmic in the size, twice the binary logarithm leaves
+    // room for both rank rules
     std::size_t MaxBuckets() const {
-        return std::ceil(std::log2(size)) + 2;
+        return 2 * (FloorLog2(size) + 1) + 1;
     }
 
     Node* Link(Node* x, Node* y) {
         if (!y)
             return x;
 
-        if (y->key < x->key)
+        if (compare(y->key, x->key))
             std::swap(x, y);
 
         y->parent = x;
@@ -239,7 +282,7 @@ private:
         return x;
     }
 
-    void MergeIntoBuckets(std::vector< Node* >& buckets, Node* n) {
+    void MergeIntoBuckets(Node* n) {
         while (buckets[n->rank]) {
             auto b = buckets[n->rank];
             buckets[n->rank] = nullptr;
@@ -247,6 +290,8 @@ private:
         }
 
         buckets[n->rank] = n;
+        if (static_cast< std::size_t >(n->rank) > maxRank)
+            maxRank = n->rank;
     }
 };
 
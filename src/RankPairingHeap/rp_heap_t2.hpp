@@ -1,13 +1,8 @@
 #pragma once
 
-#define PAIRING2
-
 #include "rp_heap.hpp"
 
 namespace MC {
-template < typename T >
-class RankPairingHeap2 : public RankPairingHeap< T > {
-public:
-    RankPairingHeap2() : RankPairingHeap< T >("rank-pairing heap t2") {}
-};
+template < typename Item, typename Key = int, typename Compare = std::less< Key > >
+using RankPairingHeap2 = RankPairingHeap< Item, Key, Compare, Type2Reduction >;
 }
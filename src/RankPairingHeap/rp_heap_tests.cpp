@@ -2,6 +2,7 @@
 
 #include "../../catch/catch.hpp"
 #include "rp_heap.hpp"
+#include "rp_heap_t2.hpp"
 #include <random>
 
 using RP = MC::RankPairingHeap< int >;
@@ -9,6 +10,7 @@ using RP = MC::RankPairingHeap< int >;
 struct Test : protected RP {
 public:
     using RP::Node;
+    using RP::NodePtr;
 
     const Node& Min() const {
         REQUIRE_NOTHROW(RP::Min());
@@ -20,7 +22,7 @@ public:
     }
 
     auto ExtractMin() {
-        std::unique_ptr< Node > i;
+        NodePtr i;
         REQUIRE_NOTHROW(i = RP::ExtractMin());
         return i;
     }
@@ -101,6 +103,79 @@ TEST_CASE("ExtractMin - random values") {
     CR(ord);
 }
 
+TEST_CASE("Pop") {
+    MC::RankPairingHeap< std::string > h;
+    auto v = Random(100);
+    for (int i : v)
+        h.Insert(i, std::to_string(i));
+
+    for (int i : CopyAndSort(v)) {
+        auto p = h.Pop();
+        CHECK(p.first == i);
+        CHECK(p.second == std::to_string(i));
+    }
+    REQUIRE(h.Empty());
+}
+
+TEST_CASE("Generic keys") {
+    MC::RankPairingHeap< int, std::pair< int, int > > h;
+    std::vector< const decltype(h)::NodeType* > inserted;
+    for (int i = 0; i < 10; ++i)
+        inserted.push_back(h.Insert({i % 3, i}, i));
+
+    h.DecreaseKey(inserted[8], {0, -1});
+    CHECK(h.Pop().second == 8);
+    CHECK(h.Pop().second == 0);
+    CHECK(h.Pop().second == 3);
+
+    MC::RankPairingHeap< int, double, std::greater< double > > g;
+    for (int i = 0; i < 10; ++i)
+        g.Insert(i * 0.5, i);
+    CHECK(g.Pop().first == 4.5);
+}
+
+TEST_CASE("Rank reduction") {
+    SECTION("rules") {
+        CHECK(MC::Type1Reduction::Rank(-1, -1) == 0);
+        CHECK(MC::Type1Reduction::Rank(0, 1) == 1);
+        CHECK(MC::Type1Reduction::Rank(2, 2) == 3);
+
+        CHECK(MC::Type2Reduction::Rank(-1, -1) == 0);
+        CHECK(MC::Type2Reduction::Rank(0, 1) == 2);
+        CHECK(MC::Type2Reduction::Rank(-1, 1) == 1);
+    }
+
+    SECTION("both types in one translation unit") {
+        MC::RankPairingHeap< int > t1;
+        MC::RankPairingHeap2< int > t2;
+        CHECK(t1.Name == "rank-pairing heap t1");
+        CHECK(t2.Name == "rank-pairing heap t2");
+
+        std::vector< const MC::RankPairingHeap< int >::NodeType* > h1;
+        std::vector< const MC::RankPairingHeap2< int >::NodeType* > h2;
+        for (int i = 0; i < 64; ++i) {
+            h1.push_back(t1.Insert(100 + i, i));
+            h2.push_back(t2.Insert(100 + i, i));
+        }
+        t1.Pop();
+        t2.Pop();
+
+        for (int i = 63; i > 0; i -= 3) {
+            t1.DecreaseKey(h1[i], i);
+            t2.DecreaseKey(h2[i], i);
+        }
+
+        std::vector< int > keys1, keys2;
+        while (!t1.Empty())
+            keys1.push_back(t1.Pop().first);
+        while (!t2.Empty())
+            keys2.push_back(t2.Pop().first);
+
+        CHECK(std::is_sorted(keys1.begin(), keys1.end()));
+        CHECK(keys1 == keys2);
+    }
+}
+
 TEST_CASE("DecreaseKey") {
 
 }
\ No newline at end of file
@@ -0,0 +1,558 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
+
+namespace MC {
+
+// Strict Fibonacci heap (Brodal, Lagogiannis, Tarjan) with worst-case rather
+// than amortized bounds: O(1) insert and decrease-key, O(log n) extract-min.
+// It is a single heap-ordered tree whose nodes are active or passive; an active
+// node with a passive parent is an active root. Each operation does a bounded
+// number of reductions, which keep the active roots, the total loss and the
+// degrees logarithmic, so no operation pays off the debt of earlier ones.
+//
+// Tree nodes refer to their entries, so that decrease-key can trade entries
+// with the root in O(1) while handles keep pointing to the same entry.
+template < typename Item, typename Key = int, typename Compare = std::less< Key > >
+class StrictFibonacciHeap : public HeapBase {
+    struct Node;
+
+    struct Entry {
+        Key key;
+        Item item;
+
+        Node* node = nullptr;
+        // insertion order, breaks ties so that no node links below its descendant
+        std::uint64_t order;
+
+        template < typename... Args >
+        Entry(std::uint64_t o, Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...), order(o) {}
+    };
+
+    // the list an active node is kept in, so that reductions are found in O(1)
+    enum class Fix : unsigned char { None, Root, Loser, Lossy };
+
+    struct Node {
+        Entry* entry;
+
+        Node* parent = nullptr;
+        // leftmost child; siblings form a circular list with the active ones
+        // on the left, and the root keeps its linkable children on the right
+        Node* child = nullptr;
+        Node* left = this;
+        Node* right = this;
+
+        // circular queue of all non-root nodes
+        Node* qNext = this;
+        Node* qPrev = this;
+
+        Node* fixNext = nullptr;
+        Node* fixPrev = nullptr;
+        unsigned fixRank = 0;
+        Fix fix = Fix::None;
+
+        bool active = false;
+        // number of active children, the rank of an active node
+        unsigned rank = 0;
+        unsigned loss = 0;
+
+        explicit Node(Entry* e) : entry(e) {}
+    };
+
+    // active roots and active nodes of loss one with a given rank
+    struct Rank {
+        Node* roots = nullptr;
+        Node* losers = nullptr;
+        std::size_t rootCount = 0;
+        std::size_t loserCount = 0;
+        // positions in rootPairs and loserPairs
+        std::size_t rootSlot = 0;
+        std::size_t loserSlot = 0;
+    };
+
+    Node* root = nullptr;
+    // front of the queue
+    Node* queue = nullptr;
+    // leftmost of the passive children of the root with no active children
+    Node* firstLinkable = nullptr;
+
+    std::vector< Rank > ranks;
+    // ranks with at least two active roots, resp. two nodes of loss one
+    std::vector< unsigned > rootPairs;
+    std::vector< unsigned > loserPairs;
+    // active nodes of loss two or more
+    Node* lossy = nullptr;
+
+    std::size_t count = 0;
+    std::uint64_t inserted = 0;
+    NodePool< Entry > entries;
+    NodePool< Node > nodes;
+    Compare compare;
+
+    bool Less(const Node* a, const Node* b) const {
+        const Entry* x = a->entry;
+        const Entry* y = b->entry;
+        if (compare(x->key, y->key))
+            return true;
+        if (compare(y->key, x->key))
+            return false;
+        return x->order < y->order;
+    }
+
+    static void Push(Node*& head, Node* n) {
+        n->fixPrev = nullptr;
+        n->fixNext = head;
+        if (head)
+            head->fixPrev = n;
+        head = n;
+    }
+
+    static void Erase(Node*& head, Node* n) {
+        if (n->fixPrev)
+            n->fixPrev->fixNext = n->fixNext;
+        else
+            head = n->fixNext;
+        if (n->fixNext)
+            n->fixNext->fixPrev = n->fixPrev;
+        n->fixNext = n->fixPrev = nullptr;
+    }
+
+    void Enlist(std::vector< unsigned >& pairs, std::size_t Rank::*slot, unsigned r) {
+        ranks[r].*slot = pairs.size();
+        pairs.push_back(r);
+    }
+
+    void Delist(std::vector< unsigned >& pairs, std::size_t Rank::*slot, unsigned r) {
+        unsigned moved = pairs.back();
+        pairs[ranks[r].*slot] = moved;
+        ranks[moved].*slot = ranks[r].*slot;
+        pairs.pop_back();
+    }
+
+    void Untrack(Node* n) {
+        switch (n->fix) {
+        case Fix::Root: {
+            Rank& r = ranks[n->fixRank];
+            Erase(r.roots, n);
+            if (--r.rootCount == 1)
+                Delist(rootPairs, &Rank::rootSlot, n->fixRank);
+            break;
+        }
+        case Fix::Loser: {
+            Rank& r = ranks[n->fixRank];
+            Erase(r.losers, n);
+            if (--r.loserCount == 1)
+                Delist(loserPairs, &Rank::loserSlot, n->fixRank);
+            break;
+        }
+        case Fix::Lossy:
+            Erase(lossy, n);
+            break;
+        case Fix::None:
+            break;
+        }
+        n->fix = Fix::None;
+    }
+
+    // files n under its current state, to be called after every change of
+    // its activity, rank, loss or parent
+    void Track(Node* n) {
+        Untrack(n);
+        if (!n->active)
+            return;
+
+        unsigned r = n->rank;
+        if (r >= ranks.size())
+            ranks.resize(r + 1);
+        n->fixRank = r;
+
+        if (!n->parent->active) {
+            n->fix = Fix::Root;
+            Push(ranks[r].roots, n);
+            if (++ranks[r].rootCount == 2)
+                Enlist(rootPairs, &Rank::rootSlot, r);
+        } else if (n->loss == 1) {
+            n->fix = Fix::Loser;
+            Push(ranks[r].losers, n);
+            if (++ranks[r].loserCount == 2)
+                Enlist(loserPairs, &Rank::loserSlot, r);
+        } else if (n->loss > 1) {
+            n->fix = Fix::Lossy;
+            Push(lossy, n);
+        }
+    }
+
+    void Enqueue(Node* n) {
+        if (!queue) {
+            queue = n->qNext = n->qPrev = n;
+            return;
+        }
+        n->qNext = queue;
+        n->qPrev = queue->qPrev;
+        queue->qPrev->qNext = n;
+        queue->qPrev = n;
+    }
+
+    void Dequeue(Node* n) {
+        if (n->qNext == n) {
+            queue = nullptr;
+        } else {
+            n->qPrev->qNext = n->qNext;
+            n->qNext->qPrev = n->qPrev;
+            if (queue == n)
+                queue = n->qNext;
+        }
+        n->qNext = n->qPrev = n;
+    }
+
+    static void AddRight(Node* p, Node* c) {
+        Node* first = p->child;
+        if (!first) {
+            p->child = c;
+            return;
+        }
+        c->left = first->left;
+        c->right = first;
+        first->left->right = c;
+        first->left = c;
+    }
+
+    static void AddLeft(Node* p, Node* c) {
+        AddRight(p, c);
+        p->child = c;
+    }
+
+    // removes c from the children of its parent, which it still points to
+    void Unlink(Node* c) {
+        Node* p = c->parent;
+        if (c == firstLinkable)
+            firstLinkable = c->right == p->child ? nullptr : c->right;
+
+        if (c->right == c) {
+            p->child = nullptr;
+        } else {
+            c->left->right = c->right;
+            c->right->left = c->left;
+            if (p->child == c)
+                p->child = c->right;
+        }
+        c->left = c->right = c;
+    }
+
+    void AddLinkable(Node* c) {
+        AddRight(root, c);
+        if (!firstLinkable)
+            firstLinkable = c;
+    }
+
+    // makes c a child of the root at the place its state calls for
+    void AddToRoot(Node* c) {
+        c->parent = root;
+        if (c->active) {
+            c->loss = 0;
+            ++root->rank;
+            AddLeft(root, c);
+        } else if (c->rank == 0) {
+            AddLinkable(c);
+        } else if (firstLinkable) {
+            c->left = firstLinkable->left;
+            c->right = firstLinkable;
+            firstLinkable->left->right = c;
+            firstLinkable->left = c;
+            if (root->child == firstLinkable)
+                root->child = c;
+        } else {
+            AddRight(root, c);
+        }
+        Track(c);
+    }
+
+    // detaches c from its parent; an active parent that is not an active root
+    // records the loss of an active child
+    void Cut(Node* c) {
+        Node* p = c->parent;
+        Unlink(c);
+        if (!c->active)
+            return;
+
+        --p->rank;
+        if (p->active) {
+            if (p->parent->active)
+                ++p->loss;
+            Track(p);
+        } else if (p->rank == 0 && p->parent == root) {
+            Unlink(p);
+            AddLinkable(p);
+        }
+    }
+
+    // makes the active node y the leftmost child of the active node x
+    void Link(Node* x, Node* y) {
+        y->parent = x;
+        y->loss = 0;
+        AddLeft(x, y);
+        ++x->rank;
+        Track(x);
+        Track(y);
+    }
+
+    // links two active roots of equal rank
+    bool ActiveRootReduction() {
+        if (rootPairs.empty())
+            return false;
+
+        Node* x = ranks[rootPairs.back()].roots;
+        Node* y = x->fixNext;
+        if (Less(y, x))
+            std::swap(x, y);
+
+        Cut(y);
+        Link(x, y);
+
+        // x keeps its degree by handing its rightmost passive child to the root
+        Node* z = x->child->left;
+        if (!z->active) {
+            Cut(z);
+            AddToRoot(z);
+        }
+        return true;
+    }
+
+    // turns three linkable children of the root into an active root of rank one
+    bool RootDegreeReduction() {
+        if (!firstLinkable)
+            return false;
+
+        Node* z = root->child->left;
+        Node* y = z->left;
+        Node* x = y->left;
+        if (z == firstLinkable || y == firstLinkable)
+            return false;
+
+        if (Less(y, x))
+            std::swap(x, y);
+        if (Less(z, y))
+            std::swap(y, z);
+        if (Less(y, x))
+            std::swap(x, y);
+
+        Unlink(x);
+        Unlink(y);
+        Unlink(z);
+
+        x->active = y->active = true;
+        z->parent = y;
+        AddRight(y, z);
+        Link(x, y);
+        AddToRoot(x);
+        return true;
+    }
+
+    bool LossReduction() {
+        if (lossy) {
+            Node* x = lossy;
+            Cut(x);
+            AddToRoot(x);
+            return true;
+        }
+
+        if (loserPairs.empty())
+            return false;
+
+        Node* x = ranks[loserPairs.back()].losers;
+        Node* y = x->fixNext;
+        if (Less(y, x))
+            std::swap(x, y);
+
+        if (y->parent == x) {
+            // x loses y and gains it back
+            y->loss = 0;
+            Track(y);
+        } else {
+            Cut(y);
+            x->loss = 0;
+            Link(x, y);
+        }
+        return true;
+    }
+
+    // makes every node of the circular list entered through c a child of the root
+    void AdoptAll(Node* c) {
+        if (!c)
+            return;
+
+        c->left->right = nullptr;
+        while (c) {
+            Node* next = c->right;
+            c->left = c->right = c;
+            AddToRoot(c);
+            c = next;
+        }
+    }
+
+public:
+    using NodeType = Entry;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Entry >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
+
+    StrictFibonacciHeap() : HeapBase("strict fibonacci heap") {
+        // ranks stay below 2 log n + O(1), this avoids regrowing them later
+        ranks.reserve(64);
+        rootPairs.reserve(64);
+        loserPairs.reserve(64);
+    }
+
+    ~StrictFibonacciHeap() {
+        if (NodePool< Entry >::TriviallyDestructible || !root)
+            return;
+
+        entries.Delete(root->entry);
+        if (Node* n = queue) {
+            do {
+                entries.Delete(n->entry);
+                n = n->qNext;
+            } while (n != queue);
+        }
+    }
+
+    bool Empty() const {
+        return count == 0;
+    }
+
+    const Entry& Min() const {
+        if (!root)
+            EmptyException();
+        return *root->entry;
+    }
+
+    const Entry* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Entry* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Entry* Emplace(Key key, Args&&... args) {
+        Entry* e = entries.New(inserted++, key, std::forward< Args >(args)...);
+        Node* n = nodes.New(e);
+        e->node = n;
+        ++count;
+
+        if (!root) {
+            root = n;
+            return e;
+        }
+
+        if (Less(n, root)) {
+            Node* old = root;
+            root = n;
+            firstLinkable = nullptr;
+            AddToRoot(old);
+            Enqueue(old);
+        } else {
+            AddToRoot(n);
+            Enqueue(n);
+        }
+
+        ActiveRootReduction();
+        RootDegreeReduction();
+        return e;
+    }
+
+    void DecreaseKey(const Entry* entry, Key key) {
+        if (compare(entry->key, key))
+            InvalidKeyException();
+
+        auto e = const_cast< Entry* >(entry);
+        e->key = key;
+        Node* x = e->node;
+        if (x == root)
+            return;
+
+        if (Less(x, root)) {
+            std::swap(x->entry, root->entry);
+            x->entry->node = x;
+            root->entry->node = root;
+        }
+        if (x->parent == root)
+            return;
+
+        Cut(x);
+        AddToRoot(x);
+
+        LossReduction();
+        for (int i = 0; i < 6 && ActiveRootReduction(); ++i) {}
+        for (int i = 0; i < 4 && RootDegreeReduction(); ++i) {}
+    }
+
+    NodePtr ExtractMin() {
+        if (!root)
+            EmptyException();
+
+        Node* old = root;
+        Entry* e = old->entry;
+        e->node = nullptr;
+        --count;
+
+        if (!old->child) {
+            root = nullptr;
+            nodes.Delete(old);
+            return entries.Own(e);
+        }
+
+        // the root has O(log n) children, the smallest one takes its place
+        Node* x = old->child;
+        for (Node* c = x->right; c != old->child; c = c->right) {
+            if (Less(c, x))
+                x = c;
+        }
+
+        Unlink(x);
+        Dequeue(x);
+        Untrack(x);
+        Node* rest = old->child;
+        Node* own = x->child;
+        nodes.Delete(old);
+
+        root = x;
+        firstLinkable = nullptr;
+        x->parent = x->child = nullptr;
+        x->active = false;
+        x->rank = x->loss = 0;
+        AdoptAll(own);
+        AdoptAll(rest);
+
+        // the front of the queue passes passive children to the root, which
+        // bounds the degree of every node
+        for (int i = 0; i < 2 && queue; ++i) {
+            Node* y = queue;
+            queue = queue->qNext;
+            for (int j = 0; j < 2 && y->child && !y->child->left->active; ++j) {
+                Node* z = y->child->left;
+                Cut(z);
+                AddToRoot(z);
+            }
+        }
+
+        LossReduction();
+        while (ActiveRootReduction() || RootDegreeReduction()) {}
+        return entries.Own(e);
+    }
+
+    std::pair< Key, Item > Pop() {
+        auto top = ExtractMin();
+        return { top->key, std::move(top->item) };
+    }
+};
+
+}
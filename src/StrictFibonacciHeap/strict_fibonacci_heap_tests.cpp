@@ -0,0 +1,90 @@
+#define CATCH_CONFIG_MAIN
+
+#include "../../catch/catch.hpp"
+#include "strict_fibonacci_heap.hpp"
+#include "../helpers/random_operations.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+using heap = MC::StrictFibonacciHeap< int >;
+
+TEST_CASE("Insert") {
+    heap h;
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.Min());
+
+    auto n = h.Insert(1, 1);
+    CHECK(&h.Min() == n);
+
+    auto m = h.Insert(0, 0);
+    CHECK(&h.Min() == m);
+
+    h.Insert(2, 2);
+    CHECK(h.Min().key == 0);
+    CHECK(h.Name == "strict fibonacci heap");
+}
+
+TEST_CASE("ExtractMin") {
+    heap h;
+    for (int i = 99; i >= 0; --i)
+        h.Insert(i, i);
+
+    for (int i = 0; i < 100; ++i) {
+        auto n = h.ExtractMin();
+        CHECK(n->key == i);
+        CHECK(n->item == i);
+    }
+    REQUIRE(h.Empty());
+    REQUIRE_THROWS(h.ExtractMin());
+}
+
+TEST_CASE("Equal keys") {
+    heap h;
+    for (int i = 0; i < 50; ++i)
+        h.Insert(i % 3, i);
+
+    for (int i = 0; i < 50; ++i)
+        CHECK(h.Pop().first == (i < 17 ? 0 : i < 34 ? 1 : 2));
+    CHECK(h.Empty());
+}
+
+TEST_CASE("DecreaseKey") {
+    heap h;
+    std::vector< heap::Handle > handles;
+    for (int i = 0; i < 20; ++i)
+        handles.push_back(h.Insert(10 + i, i));
+    h.Pop();
+
+    SECTION("below the minimum") {
+        // the entry trades places with the root's, the handle stays valid
+        h.DecreaseKey(handles[15], 0);
+        CHECK(&h.Min() == handles[15]);
+        CHECK(h.Min().item == 15);
+        h.DecreaseKey(handles[15], -1);
+        CHECK(h.Pop().first == -1);
+        CHECK(h.Pop().first == 11);
+    }
+
+    SECTION("inner nodes") {
+        h.DecreaseKey(handles[5], 12);
+        h.DecreaseKey(handles[7], 12);
+        REQUIRE_THROWS(h.DecreaseKey(handles[8], 30));
+
+        std::vector< int > expected = { 11, 12, 12, 12, 13, 14, 16, 18, 19, 20 };
+        for (int k : expected)
+            CHECK(h.Pop().first == k);
+    }
+}
+
+TEST_CASE("Emplace") {
+    MC::StrictFibonacciHeap< std::unique_ptr< std::string > > h;
+    h.Emplace(2, new std::string("two"));
+    h.Insert(1, std::make_unique< std::string >("one"));
+    CHECK(*h.Pop().second == "one");
+    CHECK(*h.Min().item == "two");
+}
+
+TEST_CASE("Random") {
+    helpers::RandomOperations< heap >(42, 20000, helpers::UniformKeys{ 1000, 100 });
+}
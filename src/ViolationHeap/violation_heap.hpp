@@ -4,17 +4,19 @@
 #include <functional>
 #include <memory>
 #include <vector>
+#include <utility>
 #include "../base/HeapBase.hpp"
+#include "../base/NodePool.hpp"
 
 namespace MC {
 
-template<typename Item>
+template < typename Item, typename Key = int, typename Compare = std::less< Key > >
 class ViolationHeap : public HeapBase {
 protected:
     struct Node {
         friend ViolationHeap;
 
-        int key;
+        Key key;
         Item item;
 
         Node* next = nullptr;
@@ -24,7 +26,9 @@ protected:
 
         int rank = 0;
 
-        Node(int k, const Item& i) : key(k), item(i) {}
+        template < typename... Args >
+        Node(Key k, Args&&... args)
+                : key(k), item(std::forward< Args >(args)...) {}
 
         void AddChild(Node* n) {
             auto c = child;
@@ -99,14 +103,6 @@ protected:
             return o;
         }
 
-        ~Node() {
-            while (child) {
-                auto n = child->next;
-                delete child;
-                child = n;
-            }
-        }
-
     };
 
     struct ZS {
@@ -130,9 +126,17 @@ protected:
 
     Node* roots = nullptr;
     std::size_t count = 0;
+    // roots by rank during consolidation, all empty in between; grows only
+    std::vector< ZS > buckets;
+    NodePool< Node > pool;
+    Compare compare;
 public:
 
     using NodeType = ViolationHeap::Node;
+    using Handle = const NodeType*;
+    using NodePtr = typename NodePool< Node >::Ptr;
+
+    constexpr static Key Infinity = KeyLimits< Key >::Infinity();
 
     ViolationHeap() : HeapBase("violation heap") {};
 
@@ -145,21 +149,30 @@ public:
         return *roots;
     }
 
-    const Node* Insert(int key, const Item& item) {
-        auto n = new Node(key, item);
+    const Node* Insert(Key key, const Item& item) {
+        return Emplace(key, item);
+    }
+
+    const Node* Insert(Key key, Item&& item) {
+        return Emplace(key, std::move(item));
+    }
+
+    template < typename... Args >
+    const Node* Emplace(Key key, Args&&... args) {
+        auto n = pool.New(key, std::forward< Args >(args)...);
         n->next = n;
         ++count;
 
         AddToRoots(n);
 
-        if (n->key < roots->key)
+        if (compare(n->key, roots->key))
             roots = n;
 
         return n;
     }
 
-    void DecreaseKey(const Node* node, int key) {
-        if (key > node->key)
+    void DecreaseKey(const Node* node, Key key) {
+        if (compare(node->key, key))
             InvalidKeyException();
 
         auto n = const_cast< Node* >(node);
@@ -167,7 +180,7 @@ public:
 
         // if is root stop; if key is smaller make it new min
         if (n->IsRoot()) {
-            if (n->key < roots->key)
+            if (compare(n->key, roots->key))
                 roots = n;
             return;
         }
@@ -175,7 +188,7 @@ public:
         Node* parent = nullptr;
 
         // If n is an active node whose new value is not smaller than its parent, stop.
-        if ((parent = Node::IsActive(n)) && n->key >= parent->key) {
+        if ((parent = Node::IsActive(n)) && !compare(n->key, parent->key)) {
             return;
         }
 
@@ -209,16 +222,16 @@ public:
         n->next = n;
 
         AddToRoots(n);
-        if (n->key < roots->key)
+        if (compare(n->key, roots->key))
             roots = n;
     }
 
-    std::unique_ptr< Node > ExtractMin() {
+    NodePtr ExtractMin() {
         if (!roots)
             EmptyException();
 
         auto min = roots;
-        std::unique_ptr< Node > ret(min);
+        NodePtr ret = pool.Own(min);
         PromoteChildren(min);
 
         if (count == 1) {
@@ -233,8 +246,14 @@ public:
         return ret;
     }
 
+    std::pair< Key, Item > Pop() {
+        auto min = ExtractMin();
+        return { min->key, std::move(min->item) };
+    }
+
     ~ViolationHeap() {
-        DeleteRoots();
+        if (!NodePool< Node >::TriviallyDestructible)
+            DeleteRoots();
     }
 
 private:
@@ -262,7 +281,7 @@ private:
             auto n = zs.Last();
             n->next = n;
             AddToRoots(n);
-            if (n->key < roots->key)
+            if (compare(n->key, roots->key))
                 roots = n;
         }
     }
@@ -287,22 +306,25 @@ private:
 
     void Consolidate(Node* end) {
         int mr = 0;
-        unsigned bound = std::ceil(std::log2(count) + 1);
-        std::vector< ZS > tmp(bound);
+        // ranks stay logarithmic in the size, twice the binary logarithm
+        // leaves room for decrease-key
+        std::size_t bound = 2 * (FloorLog2(count) + 1);
+        if (buckets.size() < bound)
+            buckets.resize(bound);
 
         auto z = roots;
         do {
             auto next = z->next;
 
-            ZS zs = tmp[z->rank];
+            ZS zs = buckets[z->rank];
             while (zs.count == 2) {
                 auto z1 = zs.z1();
                 auto z2 = zs.z2();
 
-                if (z->key > z1->key)
+                if (compare(z1->key, z->key))
                     std::swap(z, z1);
 
-                if (z->key > z2->key)
+                if (compare(z2->key, z->key))
                     std::swap(z, z2);
 
                 if (z1->rank > z2->rank)
@@ -311,12 +333,12 @@ private:
                 z->AddChild(z1);
                 z->AddChild(z2);
 
-                tmp[z->rank].Reset();
+                buckets[z->rank].Reset();
                 ++z->rank;
-                zs = tmp[z->rank];
+                zs = buckets[z->rank];
             }
 
-            tmp[z->rank].Add(z);
+            buckets[z->rank].Add(z);
 
             if (z->rank > mr)
                 mr = z->rank;
@@ -326,7 +348,7 @@ private:
         roots = nullptr;
 
         for (int i = 0; i <= mr; ++i) {
-            AddToRoots(tmp[i]);
+            AddToRoots(buckets[i]);
         }
 
     }
@@ -336,12 +358,22 @@ private:
             auto act = roots;
             do {
                 auto next = act->next;
-                delete act;
+                Free(act);
                 act = next;
             } while (act != roots);
         }
     }
 
+    // destroys n together with its subtree
+    void Free(Node* n) {
+        while (n->child) {
+            auto next = n->child->next;
+            Free(n->child);
+            n->child = next;
+        }
+        pool.Delete(n);
+    }
+
 };
 
 
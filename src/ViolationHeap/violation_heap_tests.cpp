@@ -136,6 +136,36 @@ TEST_CASE("ExtractMin") {
     }
 }
 
+TEST_CASE("Pop") {
+    MC::ViolationHeap< std::string > h;
+    for (int i = 9; i >= 0; --i)
+        h.Insert(i, std::to_string(i));
+
+    for (int i = 0; i < 10; ++i) {
+        auto p = h.Pop();
+        CHECK(p.first == i);
+        CHECK(p.second == std::to_string(i));
+    }
+    REQUIRE_THROWS(h.Pop());
+}
+
+TEST_CASE("Generic keys") {
+    MC::ViolationHeap< int, int, std::greater< int > > h;
+    std::vector< const decltype(h)::NodeType* > inserted;
+    for (int i = 0; i < 20; ++i)
+        inserted.push_back(h.Insert(i, i));
+
+    h.Pop();
+    h.DecreaseKey(inserted[5], 50);
+    REQUIRE_THROWS(h.DecreaseKey(inserted[6], 0));
+
+    CHECK(h.Pop().second == 5);
+    for (int i = 18; i >= 0; --i) {
+        if (i != 5)
+            CHECK(h.Pop().first == i);
+    }
+}
+
 //TEST_CASE("Node - Replace") {
 //    using Node = vh::NodeType;
 //
@@ -1,4 +1 @@
 #include "HeapBase.hpp"
-
-constexpr int MC::HeapBase::Infinity;
-
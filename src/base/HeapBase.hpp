@@ -1,14 +1,59 @@
 #pragma once
 
+#include <cstddef>
 #include <limits>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 namespace MC {
 
+// Sentinel larger than every key in use, e.g. the distance of an unreached
+// vertex. Pairs are compared lexicographically, so their sentinel is the
+// pair of the members' sentinels.
+template < typename Key >
+struct KeyLimits {
+    constexpr static Key Infinity() {
+        return std::numeric_limits< Key >::has_infinity
+               ? std::numeric_limits< Key >::infinity()
+               : std::numeric_limits< Key >::max();
+    }
+};
+
+template < typename First, typename Second >
+struct KeyLimits< std::pair< First, Second > > {
+    constexpr static std::pair< First, Second > Infinity() {
+        return { KeyLimits< First >::Infinity(), KeyLimits< Second >::Infinity() };
+    }
+};
+
+// floor(log2(n)) for n > 0, taken from the position of the highest set bit;
+// heaps use it to bound the degrees (ranks) seen during consolidation
+inline unsigned FloorLog2(std::size_t n) {
+    unsigned log = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    log = std::numeric_limits< unsigned long long >::digits - 1 - __builtin_clzll(n);
+#else
+    while (n >>= 1)
+        ++log;
+#endif
+    return log;
+}
+
+// order preserving map of integer keys to unsigned integers, so the monotone
+// queues can index their buckets by the bits of a key
+template < typename Key >
+typename std::make_unsigned< Key >::type ToBits(Key key) {
+    using Bits = typename std::make_unsigned< Key >::type;
+    Bits bits = static_cast< Bits >(key);
+    if (std::is_signed< Key >::value)
+        bits ^= Bits(1) << (std::numeric_limits< Bits >::digits - 1);
+    return bits;
+}
+
 class HeapBase {
 public:
-    constexpr static int Infinity = std::numeric_limits< int >::max();
-
     const std::string Name;
 
     explicit HeapBase(const std::string& name) : Name(name) {}
@@ -20,6 +65,19 @@ public:
     void InvalidKeyException() const {
         throw std::logic_error("provided key is higher than stored key");
     }
+
+    // monotone queues take no key smaller than last, the smallest key still
+    // allowed; checked in debug builds only
+    template < typename Key >
+    void CheckMonotone(Key key, Key last) const {
+#ifndef NDEBUG
+        if (key < last)
+            throw std::logic_error(Name + " key is smaller than the last extracted one");
+#else
+        static_cast< void >(key);
+        static_cast< void >(last);
+#endif
+    }
 };
 
-}
\ No newline at end of file
+}
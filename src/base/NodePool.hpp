@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace MC {
+
+// Free-list arena for the nodes of one heap. Nodes are carved from
+// contiguous chunks that grow geometrically and are recycled on Delete;
+// the chunks themselves are released with the pool, so nodes handed out
+// through Ptr must not outlive the heap that owns the pool. The arena sits
+// behind a unique_ptr so that moving the pool (and the heap) keeps the
+// address every Ptr hands its node back to.
+template < typename Node >
+class NodePool {
+    union Block {
+        Block* next;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    constexpr static std::size_t FirstChunk = 64;
+    constexpr static std::size_t MaxChunk = 4096;
+
+    struct Arena {
+        std::vector< std::unique_ptr< Block[] > > chunks;
+        Block* free = nullptr;
+        std::size_t chunkSize = FirstChunk;
+
+        void Grow() {
+            std::unique_ptr< Block[] > chunk(new Block[chunkSize]);
+            chunks.push_back(std::move(chunk));
+            Block* blocks = chunks.back().get();
+            for (std::size_t i = chunkSize; i > 0; --i) {
+                blocks[i - 1].next = free;
+                free = &blocks[i - 1];
+            }
+
+            if (chunkSize < MaxChunk)
+                chunkSize *= 2;
+        }
+
+        void* Allocate() {
+            if (!free)
+                Grow();
+            Block* b = free;
+            free = b->next;
+            return b;
+        }
+
+        void Release(void* p) {
+            Block* b = static_cast< Block* >(p);
+            b->next = free;
+            free = b;
+        }
+
+        void Delete(Node* n) {
+            n->~Node();
+            Release(n);
+        }
+    };
+
+    // created on first use, so a moved-from pool can be used again
+    std::unique_ptr< Arena > arena;
+
+public:
+    // hands a node back to its arena instead of deleting it
+    struct Deleter {
+        Arena* arena = nullptr;
+
+        void operator()(Node* n) const { arena->Delete(n); }
+    };
+
+    using Ptr = std::unique_ptr< Node, Deleter >;
+
+    // live nodes need no destructor calls when the pool goes away
+    constexpr static bool TriviallyDestructible = std::is_trivially_destructible< Node >::value;
+
+    NodePool() = default;
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    NodePool(NodePool&&) noexcept = default;
+    NodePool& operator=(NodePool&&) noexcept = default;
+
+    template < typename... Args >
+    Node* New(Args&&... args) {
+        if (!arena)
+            arena = std::make_unique< Arena >();
+        void* p = arena->Allocate();
+        try {
+            return new (p) Node(std::forward< Args >(args)...);
+        } catch (...) {
+            arena->Release(p);
+            throw;
+        }
+    }
+
+    void Delete(Node* n) {
+        arena->Delete(n);
+    }
+
+    Ptr Own(Node* n) {
+        return Ptr(n, Deleter{ arena.get() });
+    }
+};
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+#include "../../catch/catch.hpp"
+
+namespace helpers {
+
+// Keys drawn from [0, range), decreased by less than drop at a time.
+struct UniformKeys {
+    int range;
+    int drop;
+
+    int Insert(std::mt19937& rng) const {
+        return static_cast< int >(rng() % range);
+    }
+
+    int Decrease(std::mt19937& rng, int key) const {
+        return key - static_cast< int >(rng() % drop);
+    }
+
+    void Extracted(int) {}
+};
+
+// Keys for the monotone queues: inserted less than step above the last
+// extracted key and decreased to anywhere between that key and their own.
+struct MonotoneKeys {
+    int step;
+    int last;
+
+    explicit MonotoneKeys(int step, int first = 0) : step(step), last(first) {}
+
+    int Insert(std::mt19937& rng) const {
+        return last + static_cast< int >(rng() % step);
+    }
+
+    int Decrease(std::mt19937& rng, int key) const {
+        return last + static_cast< int >(rng() % (key - last + 1));
+    }
+
+    void Extracted(int key) { last = key; }
+};
+
+// Runs n random inserts, pops and decrease-keys on a Heap< int > built from
+// args and checks every step against a std::multiset. The items are the
+// insertion indices, so a popped entry can be matched to its key.
+template < typename Heap, typename Keys, typename... Args >
+void RandomOperations(unsigned seed, int n, Keys keyGen, Args&&... args) {
+    Heap h(std::forward< Args >(args)...);
+    std::mt19937 rng(seed);
+    std::vector< typename Heap::Handle > handles;
+    std::vector< int > keys;
+    std::vector< bool > live;
+    std::multiset< int > reference;
+
+    for (int i = 0; i < n; ++i) {
+        auto op = rng() % 4;
+        if (op < 2 || reference.empty()) {
+            int k = keyGen.Insert(rng);
+            handles.push_back(h.Insert(k, static_cast< int >(handles.size())));
+            keys.push_back(k);
+            live.push_back(true);
+            reference.insert(k);
+        } else if (op == 2) {
+            auto p = h.Pop();
+            REQUIRE(p.first == *reference.begin());
+            REQUIRE(keys[p.second] == p.first);
+            reference.erase(reference.begin());
+            live[p.second] = false;
+            keyGen.Extracted(p.first);
+        } else {
+            std::size_t id = rng() % handles.size();
+            if (!live[id])
+                continue;
+            int k = keyGen.Decrease(rng, keys[id]);
+            h.DecreaseKey(handles[id], k);
+            reference.erase(reference.find(keys[id]));
+            reference.insert(k);
+            keys[id] = k;
+        }
+        REQUIRE(h.Empty() == reference.empty());
+        if (!reference.empty())
+            REQUIRE(h.Min().key == *reference.begin());
+    }
+}
+
+}